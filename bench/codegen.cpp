@@ -0,0 +1,25 @@
+// Instantiates (de-)serialization of all messages. Compiled once with the
+// templated and once with the planned mode to compare build time and size.
+#include "messages.hpp"
+
+#ifdef MINISER_BENCH_PLANNED
+#include <miniser/plan.hpp>
+#define MINISER_BENCH_SERIALIZE miniser::serialize_planned
+#define MINISER_BENCH_DESERIALIZE miniser::deserialize_planned
+#else
+#include <miniser/miniser.hpp>
+#define MINISER_BENCH_SERIALIZE miniser::serialize
+#define MINISER_BENCH_DESERIALIZE miniser::deserialize
+#endif
+
+#define MINISER_BENCH_INSTANTIATE(name)                                        \
+  std::size_t roundtrip_##name(std::string_view in) {                          \
+    auto de = MINISER_BENCH_DESERIALIZE<bench::name>(in);                      \
+    if (!de) {                                                                 \
+      return 0;                                                                \
+    }                                                                          \
+    auto ser = MINISER_BENCH_SERIALIZE(*de);                                   \
+    return ser ? ser->view().size() : 0;                                       \
+  }
+
+MINISER_BENCH_MESSAGES(MINISER_BENCH_INSTANTIATE)
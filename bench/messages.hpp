@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Many similar message types, like a protocol with lots of messages
+#define MINISER_BENCH_MESSAGE(name)                                            \
+  struct name {                                                                \
+    std::uint64_t id;                                                          \
+    std::string sender;                                                        \
+    std::string recipient;                                                     \
+    std::optional<std::string> subject;                                        \
+    std::vector<std::int32_t> values;                                          \
+    double score;                                                              \
+    bool urgent;                                                               \
+    std::optional<std::uint32_t> retries;                                      \
+  };
+
+#define MINISER_BENCH_MESSAGES(X)                                              \
+  X(Message0)                                                                  \
+  X(Message1)                                                                  \
+  X(Message2)                                                                  \
+  X(Message3)                                                                  \
+  X(Message4)                                                                  \
+  X(Message5)                                                                  \
+  X(Message6)                                                                  \
+  X(Message7)                                                                  \
+  X(Message8)                                                                  \
+  X(Message9)                                                                  \
+  X(Message10)                                                                 \
+  X(Message11)                                                                 \
+  X(Message12)                                                                 \
+  X(Message13)                                                                 \
+  X(Message14)                                                                 \
+  X(Message15)                                                                 \
+  X(Message16)                                                                 \
+  X(Message17)                                                                 \
+  X(Message18)                                                                 \
+  X(Message19)                                                                 \
+  X(Message20)                                                                 \
+  X(Message21)                                                                 \
+  X(Message22)                                                                 \
+  X(Message23)                                                                 \
+  X(Message24)                                                                 \
+  X(Message25)                                                                 \
+  X(Message26)                                                                 \
+  X(Message27)                                                                 \
+  X(Message28)                                                                 \
+  X(Message29)                                                                 \
+  X(Message30)                                                                 \
+  X(Message31)
+
+namespace bench {
+
+MINISER_BENCH_MESSAGES(MINISER_BENCH_MESSAGE)
+
+} // namespace bench
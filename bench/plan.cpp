@@ -0,0 +1,61 @@
+// Compares the runtime of templated and planned (de-)serialization.
+#include "messages.hpp"
+#include <miniser/plan.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+template <typename F> double ns_per_op(std::size_t iterations, F &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < iterations; i++) {
+    fn();
+  }
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / static_cast<double>(iterations);
+}
+
+// keeps the compiler from dropping the results
+volatile std::size_t sink = 0;
+
+} // namespace
+
+int main() {
+  constexpr std::size_t iterations = 200000;
+
+  bench::Message0 msg{
+      .id = 1234567890,
+      .sender = "alice@example.com",
+      .recipient = "bob@example.com",
+      .subject = "quarterly report",
+      .values = {1, 2, 3, 5, 8, 13, 21, 34, 55, 89},
+      .score = 0.75,
+      .urgent = true,
+      .retries = std::nullopt,
+  };
+  std::string text = miniser::serialize(msg)->to_string();
+
+  std::printf("%-24s %10s %10s\n", "", "templated", "planned");
+  std::printf(
+      "%-24s %10.1f %10.1f\n", "serialize (ns/op)",
+      ns_per_op(iterations,
+                [&] { sink = sink + miniser::serialize(msg)->view().size(); }),
+      ns_per_op(iterations, [&] {
+        sink = sink + miniser::serialize_planned(msg)->view().size();
+      }));
+  std::printf(
+      "%-24s %10.1f %10.1f\n", "deserialize (ns/op)",
+      ns_per_op(iterations,
+                [&] {
+                  sink = sink + miniser::deserialize<bench::Message0>(text)
+                                    ->values.size();
+                }),
+      ns_per_op(iterations, [&] {
+        sink = sink + miniser::deserialize_planned<bench::Message0>(text)
+                          ->values.size();
+      }));
+  return 0;
+}
@@ -0,0 +1,153 @@
+// Checks that all engines agree on randomly generated values and records the
+// throughput of each engine.
+//
+// Usage: miniser-differential [--iterations N] [--seed S] [--record FILE]
+//                             [--baseline FILE] [--tolerance T]
+//
+// With `--baseline`, engines whose throughput dropped by more than the
+// tolerance (0.25 by default) compared to a file written by `--record` on the
+// same machine fail the run.
+#include "differential.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <random>
+
+namespace {
+
+struct options {
+  std::size_t iterations = 2000;
+  std::uint64_t seed = 1;
+  const char *record = nullptr;
+  const char *baseline = nullptr;
+  double tolerance = 0.25;
+};
+
+std::optional<options> parse_args(int argc, char **argv) {
+  options opts;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view arg = argv[i];
+    const char *value = argv[i + 1];
+    if (arg == "--iterations") {
+      opts.iterations = std::strtoull(value, nullptr, 10);
+    } else if (arg == "--seed") {
+      opts.seed = std::strtoull(value, nullptr, 10);
+    } else if (arg == "--record") {
+      opts.record = value;
+    } else if (arg == "--baseline") {
+      opts.baseline = value;
+    } else if (arg == "--tolerance") {
+      opts.tolerance = std::strtod(value, nullptr);
+    } else {
+      return std::nullopt;
+    }
+  }
+  if (argc % 2 == 0) {
+    return std::nullopt;
+  }
+  return opts;
+}
+
+/// MB/s of `fn` applied to all inputs
+template <typename In, typename F>
+double throughput(const std::vector<In> &inputs, std::size_t bytes, F &&fn) {
+  std::size_t ok = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &in : inputs) {
+    ok += fn(in) ? 1 : 0;
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  // keeps the compiler from dropping the calls
+  if (ok > inputs.size()) {
+    std::abort();
+  }
+  return static_cast<double>(bytes) / 1e6 / elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  auto opts = parse_args(argc, argv);
+  if (!opts) {
+    std::fprintf(stderr, "usage: %s [--iterations N] [--seed S] "
+                         "[--record FILE] [--baseline FILE] [--tolerance T]\n",
+                 argv[0]);
+    return 2;
+  }
+
+  std::mt19937_64 rng(opts->seed);
+  std::vector<fuzz::Message> values;
+  std::vector<std::string> texts;
+  std::size_t bytes = 0;
+  std::size_t mismatches = 0;
+  for (std::size_t i = 0; i < opts->iterations; i++) {
+    std::array<std::uint8_t, 512> data{};
+    for (auto &b : data) {
+      b = static_cast<std::uint8_t>(rng());
+    }
+    fuzz::source src(data);
+    fuzz::Message value{};
+    fuzz::generate(value, src);
+
+    if (auto mismatch = fuzz::check_encode(value)) {
+      if (mismatches++ < 10) {
+        std::fprintf(stderr, "iteration %zu: %.*s disagrees\n", i,
+                     static_cast<int>(mismatch->size()), mismatch->data());
+      }
+      continue;
+    }
+    if (auto text = miniser::serialize(value)) {
+      bytes += text->view().size();
+      texts.push_back(text->to_string());
+      values.push_back(std::move(value));
+    }
+  }
+
+  std::map<std::string, double, std::less<>> results;
+  for (const auto &e : fuzz::encoders<fuzz::Message>()) {
+    results[std::string(e.name)] = throughput(values, bytes, e.encode);
+  }
+  for (const auto &d : fuzz::decoders<fuzz::Message>()) {
+    results[std::string(d.name)] = throughput(
+        texts, bytes, [&](const std::string &s) { return d.decode(s); });
+  }
+
+  std::map<std::string, double, std::less<>> baseline;
+  if (opts->baseline) {
+    std::ifstream in(opts->baseline);
+    std::string name;
+    double mbps = 0;
+    while (in >> name >> mbps) {
+      baseline[name] = mbps;
+    }
+  }
+
+  std::size_t regressions = 0;
+  std::printf("%-24s %10s %10s\n", "engine", "MB/s", "baseline");
+  for (const auto &[name, mbps] : results) {
+    auto base = baseline.find(name);
+    if (base == baseline.end()) {
+      std::printf("%-24s %10.1f %10s\n", name.c_str(), mbps, "-");
+      continue;
+    }
+    bool regressed = mbps < base->second * (1 - opts->tolerance);
+    regressions += regressed ? 1 : 0;
+    std::printf("%-24s %10.1f %10.1f%s\n", name.c_str(), mbps, base->second,
+                regressed ? "  REGRESSED" : "");
+  }
+
+  if (opts->record) {
+    std::ofstream out(opts->record);
+    for (const auto &[name, mbps] : results) {
+      out << name << ' ' << mbps << '\n';
+    }
+  }
+
+  std::printf("%zu values, %zu mismatches, %zu regressions\n",
+              opts->iterations, mismatches, regressions);
+  return mismatches == 0 && regressions == 0 ? 0 : 1;
+}
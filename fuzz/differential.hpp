@@ -0,0 +1,305 @@
+#pragma once
+
+// Differential checks of all (de-)serialization engines against
+// `miniser::serialize` and `miniser::deserialize`, shared by the fuzz target
+// and the differential runner.
+#include <miniser/batch.hpp>
+#include <miniser/hash.hpp>
+#include <miniser/incremental.hpp>
+#include <miniser/plan.hpp>
+#include <miniser/project.hpp>
+#include <miniser/stream.hpp>
+#include <miniser/validate.hpp>
+
+#include <array>
+#include <boost/pfr.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace fuzz {
+
+struct Item {
+  std::int32_t count;
+  std::string label;
+  std::optional<double> weight;
+
+  bool operator==(const Item &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+
+struct Message {
+  std::uint64_t id;
+  std::int64_t delta;
+  std::string name;
+  std::vector<Item> items;
+  std::optional<std::string> note;
+  std::variant<std::int32_t, std::string, Item> choice;
+  bool flag;
+  std::vector<double> values;
+  std::uint8_t small;
+
+  bool operator==(const Message &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+
+/// Draws values from the fuzzer input (zeros once it's exhausted).
+class source {
+public:
+  explicit source(std::span<const std::uint8_t> data) : data_(data) {}
+
+  template <typename T> T next() {
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::array<std::uint8_t, sizeof(T)> bytes{};
+    auto n = std::min(bytes.size(), this->data_.size());
+    std::memcpy(bytes.data(), this->data_.data(), n);
+    this->data_ = this->data_.subspan(n);
+
+    T out;
+    std::memcpy(&out, bytes.data(), sizeof(T));
+    return out;
+  }
+
+  std::size_t below(std::size_t n) {
+    return n == 0 ? 0 : this->next<std::uint8_t>() % n;
+  }
+
+private:
+  std::span<const std::uint8_t> data_;
+};
+
+namespace detail {
+
+template <typename T> struct is_variant : std::false_type {};
+template <typename... Ts>
+struct is_variant<std::variant<Ts...>> : std::true_type {};
+
+template <typename V, std::size_t I = 0>
+void emplace_alternative(V &out, std::size_t index, source &src);
+
+} // namespace detail
+
+/// Fills `out` with values drawn from `src`.
+template <typename T> void generate(T &out, source &src) {
+  using miniser::detail::is_optional;
+  using miniser::detail::is_vector;
+
+  if constexpr (std::is_same_v<T, bool>) {
+    out = (src.next<std::uint8_t>() & 1) != 0;
+  } else if constexpr (std::is_integral_v<T>) {
+    out = src.next<T>();
+  } else if constexpr (std::is_floating_point_v<T>) {
+    // mostly short values, sometimes arbitrary bits (including NaN, which
+    // no engine may serialize)
+    if (src.below(4) == 0) {
+      out = src.next<T>();
+    } else {
+      out = static_cast<T>(src.next<std::int16_t>()) / 8;
+    }
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    // escapes, control characters and multi-byte sequences
+    static constexpr std::array<std::string_view, 14> pieces{
+        "a",  "Z",  "0",  " ",  "\"", "\\", "/",
+        "é", "€", "😀", "\n", "\t", std::string_view("\0", 1), "\x1f"};
+    out.clear();
+    for (std::size_t n = src.below(12); n > 0; n--) {
+      out.append(pieces[src.below(pieces.size())]);
+    }
+  } else if constexpr (is_vector<T>::value) {
+    out.resize(src.below(5));
+    for (auto &element : out) {
+      generate(element, src);
+    }
+  } else if constexpr (is_optional<T>::value) {
+    if (src.below(3) == 0) {
+      out.reset();
+    } else {
+      generate(out.emplace(), src);
+    }
+  } else if constexpr (detail::is_variant<T>::value) {
+    detail::emplace_alternative(out, src.below(std::variant_size_v<T>), src);
+  } else {
+    boost::pfr::for_each_field(
+        out, [&](auto &field, auto /*index*/) { generate(field, src); });
+  }
+}
+
+namespace detail {
+
+template <typename V, std::size_t I>
+void emplace_alternative(V &out, std::size_t index, source &src) {
+  if constexpr (I < std::variant_size_v<V>) {
+    if (index == I) {
+      generate(out.template emplace<I>(), src);
+    } else {
+      emplace_alternative<V, I + 1>(out, index, src);
+    }
+  }
+}
+
+} // namespace detail
+
+template <typename T> struct encoder {
+  std::string_view name;
+  std::optional<std::string> (*encode)(const T &value);
+};
+
+template <typename T> struct decoder {
+  std::string_view name;
+  std::optional<T> (*decode)(std::string_view text);
+  /// Strict decoders must reject exactly the inputs `deserialize` rejects.
+  /// The others only have to agree on inputs both accept, since they check
+  /// the input with their own scanner first (and may e.g. reject extensions).
+  bool strict;
+};
+
+/// All encoders, the reference (`serialize`) first
+template <typename T> auto encoders() {
+  return std::array<encoder<T>, 4>{{
+      {"serialize",
+       [](const T &v) -> std::optional<std::string> {
+         auto s = miniser::serialize(v);
+         return s ? std::optional(s->to_string()) : std::nullopt;
+       }},
+      {"serialize_planned",
+       [](const T &v) -> std::optional<std::string> {
+         auto s = miniser::serialize_planned(v);
+         return s ? std::optional(s->to_string()) : std::nullopt;
+       }},
+      {"serialize_to_sink",
+       [](const T &v) -> std::optional<std::string> {
+         std::string out;
+         auto append = miniser::callback_sink([&](std::string_view chunk) {
+           out.append(chunk);
+           return true;
+         });
+         // small chunks to cross as many chunk boundaries as possible
+         if (!miniser::serialize_to_sink(v, append, 7)) {
+           return std::nullopt;
+         }
+         return out;
+       }},
+      {"serialize_hashed",
+       [](const T &v) -> std::optional<std::string> {
+         auto h = miniser::serialize_hashed(v);
+         if (!h) {
+           return std::nullopt;
+         }
+         miniser::fnv1a_64 expected;
+         expected.update(h->text);
+         if (expected.digest() != h->digest) {
+           return "<digest mismatch>";
+         }
+         return std::move(h->text);
+       }},
+  }};
+}
+
+/// All decoders, the reference (`deserialize`) first
+template <typename T> auto decoders() {
+  return std::array<decoder<T>, 8>{{
+      {"deserialize",
+       [](std::string_view s) { return miniser::deserialize<T>(s); }, true},
+      {"deserialize_planned",
+       [](std::string_view s) { return miniser::deserialize_planned<T>(s); },
+       true},
+      {"deserialize_into",
+       [](std::string_view s) -> std::optional<T> {
+         std::optional<T> out(std::in_place);
+         if (!miniser::deserialize_into(s, *out)) {
+           out.reset();
+         }
+         return out;
+       },
+       true},
+      {"deserialize_borrowed",
+       [](std::string_view s) -> std::optional<T> {
+         auto b = miniser::deserialize_borrowed<T>(s);
+         return b ? std::optional(**b) : std::nullopt;
+       },
+       true},
+      {"batch_decoder",
+       [](std::string_view s) -> std::optional<T> {
+         thread_local miniser::batch_decoder<T> batch;
+         return std::move(batch.decode(std::span(&s, 1))[0]);
+       },
+       true},
+      {"deserialize_projected",
+       [](std::string_view s) { return miniser::deserialize_projected<T>(s); },
+       false},
+      {"deserialize_validated",
+       [](std::string_view s) { return miniser::deserialize_validated<T>(s); },
+       false},
+      {"incremental_decoder",
+       [](std::string_view s) -> std::optional<T> {
+         miniser::incremental_decoder<T> dec;
+         for (std::size_t i = 0; i < s.size(); i += 3) {
+           dec.feed(s.substr(i, 3));
+         }
+         if (dec.finish() != miniser::decode_status::done) {
+           return std::nullopt;
+         }
+         return dec.take();
+       },
+       false},
+  }};
+}
+
+/// Decodes `text` with all decoders. Returns the name of the first one that
+/// disagrees with `deserialize`.
+template <typename T>
+std::optional<std::string_view> check_decode(std::string_view text) {
+  auto all = decoders<T>();
+  auto expected = all[0].decode(text);
+  for (const auto &d : std::span(all).subspan(1)) {
+    auto actual = d.decode(text);
+    if (d.strict || (expected.has_value() && actual.has_value())) {
+      if (actual != expected) {
+        return d.name;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+/// Encodes `value` with all encoders and checks that the output is the same
+/// as that of `serialize`, that it decodes to `value` with all decoders and
+/// that the canonical output decodes to `value`. Returns the name of the
+/// first engine that disagrees.
+template <typename T>
+std::optional<std::string_view> check_encode(const T &value) {
+  auto all = encoders<T>();
+  auto expected = all[0].encode(value);
+  for (const auto &e : std::span(all).subspan(1)) {
+    if (e.encode(value) != expected) {
+      return e.name;
+    }
+  }
+
+  auto canonical = miniser::serialize_canonical(value);
+  if (canonical.has_value() != expected.has_value()) {
+    return "serialize_canonical";
+  }
+  if (!expected) {
+    return std::nullopt;
+  }
+
+  if (miniser::deserialize<T>(*expected) != value) {
+    return "deserialize";
+  }
+  if (miniser::deserialize<T>(*canonical) != value) {
+    return "serialize_canonical";
+  }
+  return check_decode<T>(*expected);
+}
+
+} // namespace fuzz
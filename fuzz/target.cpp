@@ -0,0 +1,32 @@
+// libFuzzer target: the first byte selects whether the rest of the input is
+// decoded as JSON or used to generate a value that is encoded.
+#include "differential.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data,
+                                      std::size_t size) {
+  if (size == 0) {
+    return 0;
+  }
+  std::span<const std::uint8_t> rest(data + 1, size - 1);
+
+  std::optional<std::string_view> mismatch;
+  if ((data[0] & 1) != 0) {
+    mismatch = fuzz::check_decode<fuzz::Message>(std::string_view(
+        reinterpret_cast<const char *>(rest.data()), rest.size()));
+  } else {
+    fuzz::source src(rest);
+    fuzz::Message value{};
+    fuzz::generate(value, src);
+    mismatch = fuzz::check_encode(value);
+  }
+
+  if (mismatch) {
+    std::fprintf(stderr, "%.*s disagrees with the reference\n",
+                 static_cast<int>(mismatch->size()), mismatch->data());
+    std::abort();
+  }
+  return 0;
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <miniser/miniser.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace miniser {
+
+namespace detail {
+
+/// A yyjson allocator that keeps freed memory for later documents
+class reusable_allocator {
+public:
+  reusable_allocator() : alc_(yyjson_alc_dyn_new()) {}
+  ~reusable_allocator() {
+    if (this->alc_) {
+      yyjson_alc_dyn_free(this->alc_);
+    }
+  }
+  reusable_allocator(const reusable_allocator &) = delete;
+  reusable_allocator(reusable_allocator &&) = delete;
+  reusable_allocator &operator=(const reusable_allocator &) = delete;
+  reusable_allocator &operator=(reusable_allocator &&) = delete;
+
+  /// `nullptr` (the default allocator) if it couldn't be created
+  [[nodiscard]] const yyjson_alc *get() const { return this->alc_; }
+
+private:
+  yyjson_alc *alc_;
+};
+
+/// Threads that are kept to run the ranges of many batches
+class worker_pool {
+public:
+  worker_pool() = default;
+  ~worker_pool() {
+    {
+      std::lock_guard lock(this->mutex_);
+      this->stop_ = true;
+    }
+    this->wake_.notify_all();
+    for (auto &thread : this->threads_) {
+      thread.join();
+    }
+  }
+  worker_pool(const worker_pool &) = delete;
+  worker_pool(worker_pool &&) = delete;
+  worker_pool &operator=(const worker_pool &) = delete;
+  worker_pool &operator=(worker_pool &&) = delete;
+
+  /// Runs `task(0)` to `task(n - 1)` in parallel (the last one on the calling
+  /// thread) and returns once all of them are done. Threads are only started
+  /// the first time that many are needed.
+  template <typename F> void run(std::size_t n, F &task) {
+    if (n == 0) {
+      return;
+    }
+    while (this->threads_.size() < n - 1) {
+      this->threads_.emplace_back(
+          [this, index = this->threads_.size(), seen = this->generation_] {
+            this->work(index, seen);
+          });
+    }
+
+    {
+      std::lock_guard lock(this->mutex_);
+      this->task_ = [](void *fn, std::size_t index) {
+        (*static_cast<F *>(fn))(index);
+      };
+      this->fn_ = &task;
+      this->active_ = n - 1;
+      this->pending_ = n - 1;
+      this->generation_++;
+    }
+    this->wake_.notify_all();
+
+    task(n - 1);
+    std::unique_lock lock(this->mutex_);
+    this->done_.wait(lock, [this] { return this->pending_ == 0; });
+  }
+
+private:
+  void work(std::size_t index, std::size_t seen) {
+    std::unique_lock lock(this->mutex_);
+    while (true) {
+      this->wake_.wait(lock, [&] {
+        return this->stop_ || this->generation_ != seen;
+      });
+      if (this->stop_) {
+        return;
+      }
+      seen = this->generation_;
+      if (index >= this->active_) {
+        continue;
+      }
+
+      auto *task = this->task_;
+      auto *fn = this->fn_;
+      lock.unlock();
+      task(fn, index);
+      lock.lock();
+      if (--this->pending_ == 0) {
+        this->done_.notify_one();
+      }
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  bool stop_ = false;
+  /// Incremented for every call to `run`
+  std::size_t generation_ = 0;
+  void (*task_)(void *, std::size_t) = nullptr;
+  void *fn_ = nullptr;
+  /// Number of workers that run a task in the current generation
+  std::size_t active_ = 0;
+  std::size_t pending_ = 0;
+};
+
+} // namespace detail
+
+/// Decodes many small documents of the same type.
+///
+/// Documents are read with an allocator that is kept across calls, so after
+/// the first batch, reading a document doesn't allocate. Results are decoded
+/// into the values of the previous batch (see `deserialize_into`), reusing
+/// their strings and vectors.
+template <typename T> class batch_decoder {
+public:
+  explicit batch_decoder(deser::context ctx = {}, yyjson_read_flag flags = 0)
+      : ctx_(ctx), flags_(flags) {}
+
+  /// Decodes `inputs[i]` into the `i`-th result (empty if it's invalid).
+  ///
+  /// With `threads > 1`, the inputs are split into that many ranges which are
+  /// decoded in parallel, each with its own allocator. The worker threads are
+  /// started by the first call that needs them and kept until the decoder is
+  /// destroyed. The results are valid until the next call.
+  std::span<std::optional<T>> decode(std::span<const std::string_view> inputs,
+                                     std::size_t threads = 1) {
+    this->results_.resize(inputs.size());
+    if (inputs.empty()) {
+      return this->results_;
+    }
+
+    threads = std::clamp<std::size_t>(threads, 1, inputs.size());
+    while (this->allocators_.size() < threads) {
+      this->allocators_.push_back(
+          std::make_unique<detail::reusable_allocator>());
+    }
+
+    if (threads <= 1) {
+      this->decode_range(inputs, this->results_, 0);
+      return this->results_;
+    }
+
+    std::size_t per_thread = (inputs.size() + threads - 1) / threads;
+    auto decode_part = [&](std::size_t t) {
+      auto begin = t * per_thread;
+      auto n = std::min(per_thread, inputs.size() - begin);
+      this->decode_range(inputs.subspan(begin, n),
+                         std::span(this->results_).subspan(begin, n), t);
+    };
+    if (!this->pool_) {
+      this->pool_ = std::make_unique<detail::worker_pool>();
+    }
+    this->pool_->run((inputs.size() + per_thread - 1) / per_thread,
+                     decode_part);
+    return this->results_;
+  }
+
+private:
+  void decode_range(std::span<const std::string_view> inputs,
+                    std::span<std::optional<T>> out, std::size_t allocator) {
+    const auto *alc = this->allocators_[allocator]->get();
+    for (std::size_t i = 0; i < inputs.size(); i++) {
+      this->decode_one(inputs[i], out[i], alc);
+    }
+  }
+
+  void decode_one(std::string_view str, std::optional<T> &out,
+                  const yyjson_alc *alc) {
+    metrics::probe<T> probe(metrics::operation::deserialize, str.size(), alc);
+    detail::yydoc doc = detail::read(str, this->flags_, probe.allocator());
+    probe.parsed();
+    if (!doc()) {
+      out.reset();
+      return;
+    }
+
+    auto *root = yyjson_doc_get_root(doc());
+    detail::source_text source(str, doc());
+    auto ctx = detail::with_source(this->ctx_, source);
+    if constexpr (std::is_default_constructible_v<T>) {
+      if (!out.has_value()) {
+        out.emplace();
+      }
+      if (!deser::deserialize_into(*out, root, ctx)) {
+        out.reset();
+      }
+    } else {
+      out = deser::deserialize(std::type_identity<T>{}, root, ctx);
+    }
+    probe.converted();
+    if (out.has_value()) {
+      probe.succeed();
+    }
+  }
+
+  deser::context ctx_;
+  yyjson_read_flag flags_;
+  std::vector<std::optional<T>> results_;
+  std::vector<std::unique_ptr<detail::reusable_allocator>> allocators_;
+  std::unique_ptr<detail::worker_pool> pool_;
+};
+
+} // namespace miniser
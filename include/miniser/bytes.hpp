@@ -0,0 +1,103 @@
+#pragma once
+
+#include <miniser/detail/binary.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace miniser {
+
+enum class bytes_encoding {
+  /// RFC 4648 base64 with padding
+  base64,
+  /// Lowercase hex (either case is accepted when deserializing)
+  hex,
+};
+
+/// Binary data that's written as a base64 or hex string.
+///
+/// The data is decoded straight from the parsed string (into the existing
+/// storage with `deserialize_into`). `serialize_to_sink` encodes it straight
+/// into the output; `serialize` encodes it into a buffer that yyjson copies
+/// (on the stack for short data).
+template <bytes_encoding E> class basic_bytes {
+public:
+  basic_bytes() = default;
+  explicit basic_bytes(std::vector<std::byte> data) : data_(std::move(data)) {}
+  explicit basic_bytes(std::span<const std::byte> data)
+      : data_(data.begin(), data.end()) {}
+
+  [[nodiscard]] std::span<const std::byte> view() const { return this->data_; }
+  [[nodiscard]] const std::vector<std::byte> &vec() const {
+    return this->data_;
+  }
+  [[nodiscard]] std::vector<std::byte> &vec() { return this->data_; }
+
+  [[nodiscard]] std::size_t size() const { return this->data_.size(); }
+  [[nodiscard]] bool empty() const { return this->data_.empty(); }
+
+  bool operator==(const basic_bytes &other) const = default;
+
+private:
+  std::vector<std::byte> data_;
+};
+
+using bytes = basic_bytes<bytes_encoding::base64>;
+using hex_bytes = basic_bytes<bytes_encoding::hex>;
+
+namespace detail {
+
+template <typename T> struct is_bytes : std::false_type {};
+template <bytes_encoding E>
+struct is_bytes<basic_bytes<E>> : std::true_type {};
+
+template <bytes_encoding E> constexpr std::size_t encoded_size(std::size_t n) {
+  if constexpr (E == bytes_encoding::base64) {
+    return binary::base64_encoded_size(n);
+  } else {
+    return binary::hex_encoded_size(n);
+  }
+}
+
+/// Writes `encoded_size<E>(data.size())` characters to `out`.
+template <bytes_encoding E>
+void encode_bytes(std::span<const std::byte> data, char *out) {
+  const auto *in = reinterpret_cast<const std::uint8_t *>(data.data());
+  if constexpr (E == bytes_encoding::base64) {
+    binary::base64_encode(in, data.size(), out);
+  } else {
+    binary::hex_encode(in, data.size(), out);
+  }
+}
+
+/// Decodes `text` into `out`, reusing its storage.
+template <bytes_encoding E>
+bool decode_bytes(std::string_view text, std::vector<std::byte> &out) {
+  std::optional<std::size_t> size;
+  if constexpr (E == bytes_encoding::base64) {
+    size = binary::base64_decoded_size(text);
+  } else {
+    size = binary::hex_decoded_size(text);
+  }
+  if (!size.has_value()) {
+    return false;
+  }
+
+  out.resize(*size);
+  auto *dst = reinterpret_cast<std::uint8_t *>(out.data());
+  if constexpr (E == bytes_encoding::base64) {
+    return binary::base64_decode(text, dst);
+  } else {
+    return binary::hex_decode(text, dst);
+  }
+}
+
+} // namespace detail
+
+} // namespace miniser
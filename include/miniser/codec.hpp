@@ -0,0 +1,71 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+namespace miniser {
+
+/// Specialize to (de-)serialize a type that isn't supported out of the box
+/// (or to change how an aggregate is represented). There are two kinds of
+/// codecs:
+///
+/// - Mapped codecs convert to and from another supported type `repr`:
+///
+///   ```c++
+///   template <> struct miniser::codec<std::chrono::milliseconds> {
+///     using repr = std::int64_t;
+///     static repr encode(std::chrono::milliseconds v) { return v.count(); }
+///     static std::optional<std::chrono::milliseconds> decode(repr r) {
+///       return std::chrono::milliseconds(r);
+///     }
+///   };
+///   ```
+///
+/// - String codecs write a JSON string of at most `max_size` bytes straight
+///   into the output and read it from the parsed value without going through
+///   a `std::string`:
+///
+///   ```c++
+///   template <> struct miniser::codec<uuid> {
+///     static constexpr std::size_t max_size = 32;
+///     /// Writes at most `max_size` bytes to `out` and returns their number
+///     static std::size_t encode(const uuid &v, char *out);
+///     static std::optional<uuid> decode(std::string_view text);
+///   };
+///   ```
+///
+/// Codecs take priority over the (de-)serialization of aggregates.
+template <typename T> struct codec {};
+
+template <typename T>
+concept mapped_codec =
+    requires(const T &value, const typename codec<T>::repr &r) {
+      {
+        codec<T>::encode(value)
+      } -> std::convertible_to<typename codec<T>::repr>;
+      { codec<T>::decode(r) } -> std::same_as<std::optional<T>>;
+    };
+
+template <typename T>
+concept string_codec =
+    requires(const T &value, char *out, std::string_view text) {
+      requires codec<T>::max_size > 0;
+      { codec<T>::encode(value, out) } -> std::same_as<std::size_t>;
+      { codec<T>::decode(text) } -> std::same_as<std::optional<T>>;
+    };
+
+template <typename T>
+concept has_codec = mapped_codec<T> || string_codec<T>;
+
+namespace detail {
+
+/// Aggregates are (de-)serialized as objects unless they have a codec
+template <typename T>
+inline constexpr bool is_object_v = std::is_aggregate_v<T> && !has_codec<T>;
+
+} // namespace detail
+
+} // namespace miniser
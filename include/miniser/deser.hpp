@@ -1,11 +1,21 @@
 #pragma once
 
 #include <boost/pfr.hpp>
+#include <charconv>
 #include <limits>
+#include <miniser/bytes.hpp>
+#include <miniser/codec.hpp>
 #include <miniser/detail/names.hpp>
+#include <miniser/detail/skip.hpp>
+#include <miniser/detail/source.hpp>
+#include <miniser/detail/variant.hpp>
+#include <miniser/raw.hpp>
 #include <optional>
 #include <string_view>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <variant>
 #include <vector>
 #include <yyjson.h>
 
@@ -13,14 +23,17 @@ namespace miniser::deser {
 
 enum class option {
   none = 0,
-  /// Check range for (u)int{8,16,32}_t
+  /// Check range for (u)int{8,16,32}_t and float
   check_range = (1 << 0),
-  /// Don't deserialize integers as double
+  /// Don't deserialize integers as floating point numbers
   strict_real = (1 << 1),
 };
 
 struct context {
   option options = option::none;
+  /// The text of the document, to keep `raw_json` values byte for byte (set
+  /// by the functions that read a document)
+  miniser::detail::source_text *source = nullptr;
 
   [[nodiscard]] bool has_option(option opt) const {
     return (static_cast<std::underlying_type_t<option>>(this->options) &
@@ -30,9 +43,73 @@ struct context {
 
 namespace detail {
 
+/// Looks up the members of an object for the fields of an aggregate, in the
+/// order of the fields.
+///
+/// Objects written by `serialize` have their members in that order, so each
+/// lookup first compares the member after the last one that was found this
+/// way. Members that don't belong to a field or belong to a previous one (e.g.
+/// the tag of an internally tagged variant) are skipped. The object is only
+/// searched if the next member belongs to a later field (e.g. if a field was
+/// left out or the members were reordered). Skipped members never have the
+/// key of the current or a later field, so duplicate keys resolve to the
+/// first occurrence like with a search.
+class ordered_members {
+public:
+  explicit ordered_members(yyjson_val *obj)
+      : obj_(obj), iter_(yyjson_obj_iter_with(obj)),
+        next_(yyjson_obj_iter_next(&this->iter_)) {}
+
+  /// The value of the member `key` (`nullptr` if it's missing).
+  /// `is_later(k)` tells whether a member with the key `k` belongs to a field
+  /// after the one that's looked up.
+  template <typename F> yyjson_val *find(std::string_view key, F &&is_later) {
+    while (this->next_) {
+      if (yyjson_equals_strn(this->next_, key.data(), key.size())) {
+        auto *value = yyjson_obj_iter_get_val(this->next_);
+        this->next_ = yyjson_obj_iter_next(&this->iter_);
+        return value;
+      }
+      if (is_later(std::string_view(yyjson_get_str(this->next_),
+                                    yyjson_get_len(this->next_)))) {
+        break;
+      }
+      this->next_ = yyjson_obj_iter_next(&this->iter_);
+    }
+    return yyjson_obj_getn(this->obj_, key.data(), key.size());
+  }
+
+private:
+  yyjson_val *obj_;
+  yyjson_obj_iter iter_;
+  yyjson_val *next_;
+};
+
+/// The member for the field `I` of `T`
+template <typename T, std::size_t I>
+yyjson_val *find_field(ordered_members &members) {
+  return members.find(miniser::detail::name_of_field<I, T>,
+                      [](std::string_view key) {
+                        auto index = miniser::detail::field_index<T>(key);
+                        return index > I &&
+                               index < miniser::detail::field_names<T>.size();
+                      });
+}
+
 template <typename T>
 std::optional<T> get_integer(yyjson_val *value, const context &ctx);
 
+template <typename T>
+std::optional<T> get_real(yyjson_val *value, const context &ctx);
+
+template <typename V>
+std::optional<V> get_alternative(std::size_t index, yyjson_val *value,
+                                 const context &ctx);
+
+template <typename T, std::size_t... I>
+std::optional<T> construct_aggregate(yyjson_val *value, const context &ctx,
+                                     std::index_sequence<I...>);
+
 } // namespace detail
 
 // Declarations
@@ -57,8 +134,12 @@ std::optional<std::uint32_t> deserialize(std::type_identity<std::uint32_t>,
 std::optional<std::uint64_t> deserialize(std::type_identity<std::uint64_t>,
                                          yyjson_val *value, const context &ctx);
 
+std::optional<float> deserialize(std::type_identity<float>, yyjson_val *value,
+                                 const context &ctx);
 std::optional<double> deserialize(std::type_identity<double>, yyjson_val *value,
                                   const context &ctx);
+std::optional<long double> deserialize(std::type_identity<long double>,
+                                       yyjson_val *value, const context &ctx);
 
 std::optional<std::string> deserialize(std::type_identity<std::string>,
                                        yyjson_val *value, const context &ctx);
@@ -68,13 +149,33 @@ std::optional<std::string_view>
 deserialize(std::type_identity<std::string_view>, yyjson_val *value,
             const context &ctx);
 
+std::optional<raw_number> deserialize(std::type_identity<raw_number>,
+                                      yyjson_val *value, const context &ctx);
+std::optional<raw_json> deserialize(std::type_identity<raw_json>,
+                                    yyjson_val *value, const context &ctx);
+
+// Warning: this must be used with deserialize_borrowed!
+std::optional<raw_json_view> deserialize(std::type_identity<raw_json_view>,
+                                         yyjson_val *value,
+                                         const context &ctx);
+
+template <bytes_encoding E>
+std::optional<basic_bytes<E>> deserialize(std::type_identity<basic_bytes<E>>,
+                                          yyjson_val *value,
+                                          const context &ctx);
+
 template <typename T>
 std::optional<std::vector<T>> deserialize(std::type_identity<std::vector<T>>,
                                           yyjson_val *value,
                                           const context &ctx);
 
 template <typename T>
-  requires std::is_aggregate_v<T>
+  requires miniser::detail::is_object_v<T>
+std::optional<T> deserialize(std::type_identity<T>, yyjson_val *value,
+                             const context &ctx);
+
+template <typename T>
+  requires has_codec<T>
 std::optional<T> deserialize(std::type_identity<T>, yyjson_val *value,
                              const context &ctx);
 
@@ -83,6 +184,37 @@ std::optional<std::optional<T>>
 deserialize(std::type_identity<std::optional<T>>, yyjson_val *value,
             const context &ctx);
 
+template <typename... Ts>
+std::optional<std::variant<Ts...>>
+deserialize(std::type_identity<std::variant<Ts...>>, yyjson_val *value,
+            const context &ctx);
+
+// Deserializes into an existing object, reusing its storage (e.g. the
+// capacity of strings and vectors). Aggregates and vectors are decoded in
+// place, without moving fields or elements from temporaries. On failure, `out`
+// is left in a valid but unspecified state.
+
+template <typename T>
+bool deserialize_into(T &out, yyjson_val *value, const context &ctx);
+
+bool deserialize_into(std::string &out, yyjson_val *value, const context &ctx);
+
+template <bytes_encoding E>
+bool deserialize_into(basic_bytes<E> &out, yyjson_val *value,
+                      const context &ctx);
+
+template <typename T>
+bool deserialize_into(std::vector<T> &out, yyjson_val *value,
+                      const context &ctx);
+
+template <typename T>
+  requires miniser::detail::is_object_v<T>
+bool deserialize_into(T &out, yyjson_val *value, const context &ctx);
+
+template <typename T>
+bool deserialize_into(std::optional<T> &out, yyjson_val *value,
+                      const context &ctx);
+
 // Implementations
 
 inline std::optional<bool> deserialize(std::type_identity<bool>,
@@ -94,58 +226,61 @@ inline std::optional<bool> deserialize(std::type_identity<bool>,
 }
 
 template <typename T>
-  requires std::is_aggregate_v<T>
+  requires miniser::detail::is_object_v<T>
 std::optional<T> deserialize(std::type_identity<T>, yyjson_val *value,
                              const context &ctx) {
-  if (!yyjson_is_obj(value)) {
-    return std::nullopt;
+  if constexpr (std::is_default_constructible_v<T>) {
+    // decode directly into the returned storage
+    std::optional<T> out(std::in_place);
+    if (!deserialize_into(*out, value, ctx)) {
+      return std::nullopt;
+    }
+    return out;
+  } else {
+    return detail::construct_aggregate<T>(
+        value, ctx, std::make_index_sequence<boost::pfr::tuple_size_v<T>>{});
   }
+}
 
-  T foo;
-  bool ok = true;
-  boost::pfr::for_each_field(foo, [&](auto &field, auto index) {
-    if (!ok) {
-      return;
-    }
-    auto key = miniser::detail::name_of_field<index, T>;
-    auto *inner = yyjson_obj_getn(value, key.data(), key.size());
-    auto xd = deserialize(
-        std::type_identity<std::remove_reference_t<decltype(field)>>{}, inner,
-        ctx);
-    if (xd.has_value()) {
-      field = std::move(*xd);
-    } else {
-      ok = false;
-    }
-  });
-  if (ok) {
-    return std::move(foo);
+template <bytes_encoding E>
+std::optional<basic_bytes<E>> deserialize(std::type_identity<basic_bytes<E>>,
+                                          yyjson_val *value,
+                                          const context &ctx) {
+  std::optional<basic_bytes<E>> out(std::in_place);
+  if (!deserialize_into(*out, value, ctx)) {
+    return std::nullopt;
   }
-  return std::nullopt;
+  return out;
 }
 
 template <typename T>
 std::optional<std::vector<T>> deserialize(std::type_identity<std::vector<T>>,
                                           yyjson_val *value,
                                           const context &ctx) {
-  if (!yyjson_is_arr(value)) {
+  std::optional<std::vector<T>> vec(std::in_place);
+  if (!deserialize_into(*vec, value, ctx)) {
     return std::nullopt;
   }
+  return vec;
+}
 
-  std::vector<T> vec;
-  vec.reserve(yyjson_arr_size(value));
-
-  yyjson_val *inner = nullptr;
-  yyjson_arr_iter iter = yyjson_arr_iter_with(value);
-  while ((inner = yyjson_arr_iter_next(&iter))) {
-    auto deserialized = deserialize(std::type_identity<T>{}, inner, ctx);
-    if (!deserialized.has_value()) {
+template <typename T>
+  requires has_codec<T>
+std::optional<T> deserialize(std::type_identity<T>, yyjson_val *value,
+                             const context &ctx) {
+  if constexpr (string_codec<T>) {
+    if (!yyjson_is_str(value)) {
+      return std::nullopt;
+    }
+    return codec<T>::decode({yyjson_get_str(value), yyjson_get_len(value)});
+  } else {
+    auto repr = deserialize(std::type_identity<typename codec<T>::repr>{},
+                            value, ctx);
+    if (!repr.has_value()) {
       return std::nullopt;
     }
-    vec.push_back(std::move(*deserialized));
+    return codec<T>::decode(*repr);
   }
-
-  return vec;
 }
 
 inline std::optional<std::int8_t> deserialize(std::type_identity<std::int8_t>,
@@ -196,24 +331,20 @@ deserialize(std::type_identity<std::uint64_t>, yyjson_val *value,
   return detail::get_integer<std::uint64_t>(value, ctx);
 }
 
+inline std::optional<float>
+deserialize(std::type_identity<float>, yyjson_val *value, const context &ctx) {
+  return detail::get_real<float>(value, ctx);
+}
+
 inline std::optional<double>
 deserialize(std::type_identity<double>, yyjson_val *value, const context &ctx) {
-  if (yyjson_is_real(value)) {
-    return yyjson_get_real(value);
-  }
-
-  if (ctx.has_option(option::strict_real)) {
-    return std::nullopt;
-  }
+  return detail::get_real<double>(value, ctx);
+}
 
-  // try uint first to get a better range
-  if (yyjson_is_uint(value)) {
-    return static_cast<double>(yyjson_get_uint(value));
-  }
-  if (yyjson_is_int(value)) {
-    return static_cast<double>(yyjson_get_sint(value));
-  }
-  return std::nullopt;
+inline std::optional<long double> deserialize(std::type_identity<long double>,
+                                              yyjson_val *value,
+                                              const context &ctx) {
+  return detail::get_real<long double>(value, ctx);
 }
 
 inline std::optional<std::string> deserialize(std::type_identity<std::string>,
@@ -245,6 +376,66 @@ deserialize(std::type_identity<std::string_view>, yyjson_val *value,
   return std::string_view(s, size);
 }
 
+inline std::optional<raw_number> deserialize(std::type_identity<raw_number>,
+                                             yyjson_val *value,
+                                             const context &) {
+  if (yyjson_is_raw(value)) {
+    return raw_number(
+        std::string(yyjson_get_raw(value), yyjson_get_len(value)));
+  }
+  if (!yyjson_is_num(value)) {
+    return std::nullopt;
+  }
+
+  size_t size = 0;
+  char *s = yyjson_val_write(value, 0, &size);
+  if (!s) {
+    return std::nullopt;
+  }
+  raw_number number(std::string(s, size));
+  // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+  free(s);
+  return number;
+}
+
+inline std::optional<raw_json> deserialize(std::type_identity<raw_json>,
+                                           yyjson_val *value,
+                                           const context &ctx) {
+  if (!value) {
+    return std::nullopt;
+  }
+  if (ctx.source) {
+    if (auto text = ctx.source->find(value)) {
+      return raw_json(std::string(*text));
+    }
+  }
+
+  size_t size = 0;
+  char *s = yyjson_val_write(value, 0, &size);
+  if (!s) {
+    return std::nullopt;
+  }
+  raw_json json(std::string(s, size));
+  // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+  free(s);
+  return json;
+}
+
+// Warning: this must be used with deserialize_borrowed!
+inline std::optional<raw_json_view>
+deserialize(std::type_identity<raw_json_view>, yyjson_val *value,
+            const context &ctx) {
+  if (!value) {
+    return std::nullopt;
+  }
+  if (ctx.source) {
+    if (auto text = ctx.source->find(value)) {
+      return raw_json_view(value, *text);
+    }
+  }
+  return raw_json_view(value);
+}
+
 template <typename T>
 std::optional<std::optional<T>>
 deserialize(std::type_identity<std::optional<T>>, yyjson_val *value,
@@ -255,19 +446,194 @@ deserialize(std::type_identity<std::optional<T>>, yyjson_val *value,
   return deserialize(std::type_identity<T>{}, value, ctx);
 }
 
+template <typename... Ts>
+std::optional<std::variant<Ts...>>
+deserialize(std::type_identity<std::variant<Ts...>>, yyjson_val *value,
+            const context &ctx) {
+  using V = std::variant<Ts...>;
+
+  if (!yyjson_is_obj(value)) {
+    return std::nullopt;
+  }
+
+  yyjson_val *tag = nullptr;
+  yyjson_val *inner = nullptr;
+  if constexpr (tag_variant<V> == tagging::external) {
+    if (yyjson_obj_size(value) != 1) {
+      return std::nullopt;
+    }
+    yyjson_obj_iter iter = yyjson_obj_iter_with(value);
+    tag = yyjson_obj_iter_next(&iter);
+    inner = yyjson_obj_iter_get_val(tag);
+  } else {
+    auto tag_key = variant_tag_field<V>;
+    tag = yyjson_obj_getn(value, tag_key.data(), tag_key.size());
+    if constexpr (tag_variant<V> == tagging::internal) {
+      inner = value;
+    } else {
+      auto content_key = variant_content_field<V>;
+      inner = yyjson_obj_getn(value, content_key.data(), content_key.size());
+    }
+  }
+
+  if (!yyjson_is_str(tag)) {
+    return std::nullopt;
+  }
+  auto index = miniser::detail::variant_tags<V>::find(
+      {yyjson_get_str(tag), yyjson_get_len(tag)});
+  if (index >= sizeof...(Ts)) {
+    return std::nullopt;
+  }
+  return detail::get_alternative<V>(index, inner, ctx);
+}
+
+template <typename T>
+bool deserialize_into(T &out, yyjson_val *value, const context &ctx) {
+  auto de = deserialize(std::type_identity<T>{}, value, ctx);
+  if (!de.has_value()) {
+    return false;
+  }
+  out = std::move(*de);
+  return true;
+}
+
+inline bool deserialize_into(std::string &out, yyjson_val *value,
+                             const context &) {
+  if (!yyjson_is_str(value)) {
+    return false;
+  }
+  const char *s = yyjson_get_str(value);
+  if (!s) {
+    return false;
+  }
+  out.assign(s, yyjson_get_len(value));
+  return true;
+}
+
+template <bytes_encoding E>
+bool deserialize_into(basic_bytes<E> &out, yyjson_val *value,
+                      const context &) {
+  if (!yyjson_is_str(value)) {
+    return false;
+  }
+  return miniser::detail::decode_bytes<E>(
+      {yyjson_get_str(value), yyjson_get_len(value)}, out.vec());
+}
+
+template <typename T>
+bool deserialize_into(std::vector<T> &out, yyjson_val *value,
+                      const context &ctx) {
+  if (!yyjson_is_arr(value)) {
+    return false;
+  }
+
+  yyjson_val *inner = nullptr;
+  yyjson_arr_iter iter = yyjson_arr_iter_with(value);
+  // existing elements are reused (unless they can't be referenced, like the
+  // ones of std::vector<bool>)
+  if constexpr (std::is_default_constructible_v<T> &&
+                std::is_same_v<decltype(out[0]), T &>) {
+    out.resize(yyjson_arr_size(value));
+    std::size_t i = 0;
+    while ((inner = yyjson_arr_iter_next(&iter))) {
+      if (!deserialize_into(out[i++], inner, ctx)) {
+        return false;
+      }
+    }
+  } else {
+    out.clear();
+    out.reserve(yyjson_arr_size(value));
+    while ((inner = yyjson_arr_iter_next(&iter))) {
+      auto deserialized = deserialize(std::type_identity<T>{}, inner, ctx);
+      if (!deserialized.has_value()) {
+        return false;
+      }
+      out.push_back(std::move(*deserialized));
+    }
+  }
+  return true;
+}
+
+template <typename T>
+  requires miniser::detail::is_object_v<T>
+bool deserialize_into(T &out, yyjson_val *value, const context &ctx) {
+  if (!yyjson_is_obj(value)) {
+    return false;
+  }
+
+  bool ok = true;
+  detail::ordered_members members(value);
+  boost::pfr::for_each_field(out, [&](auto &field, auto index) {
+    if (!ok) {
+      return;
+    }
+    auto *inner = detail::find_field<T, index>(members);
+    if constexpr (std::is_default_constructible_v<
+                      std::remove_reference_t<decltype(field)>>) {
+      if (!inner && default_missing_fields<T>) {
+        field = {};
+        return;
+      }
+    }
+    ok = deserialize_into(field, inner, ctx);
+  });
+  return ok;
+}
+
+template <typename T>
+bool deserialize_into(std::optional<T> &out, yyjson_val *value,
+                      const context &ctx) {
+  // same as deserialize: invalid values are treated as missing
+  if (!value || yyjson_is_null(value)) {
+    out.reset();
+    return true;
+  }
+  if constexpr (std::is_default_constructible_v<T>) {
+    if (!out.has_value()) {
+      out.emplace();
+    }
+    if (!deserialize_into(*out, value, ctx)) {
+      out.reset();
+    }
+  } else {
+    out = deserialize(std::type_identity<T>{}, value, ctx);
+  }
+  return true;
+}
+
 namespace detail {
 
+/// Parses a number that was read as text (with `YYJSON_READ_NUMBER_AS_RAW`
+/// or `YYJSON_READ_BIGNUM_AS_RAW`) as an `N`.
+template <typename N> std::optional<N> parse_raw(yyjson_val *value) {
+  std::string_view text(yyjson_get_raw(value), yyjson_get_len(value));
+  const char *end = text.data() + text.size();
+  N out{};
+  auto res = std::from_chars(text.data(), end, out);
+  if (res.ec != std::errc{} || res.ptr != end) {
+    return std::nullopt;
+  }
+  return out;
+}
+
 template <typename T>
 std::optional<T> get_integer(yyjson_val *value, const context &ctx) {
   static_assert(sizeof(T) <= 8);
 
   if constexpr (std::numeric_limits<T>::is_signed) {
-    if (!yyjson_is_int(value)) {
+    std::int64_t sint = 0;
+    if (yyjson_is_raw(value)) {
+      auto parsed = parse_raw<std::int64_t>(value);
+      if (!parsed.has_value()) {
+        return std::nullopt;
+      }
+      sint = *parsed;
+    } else if (yyjson_is_int(value)) {
+      sint = yyjson_get_sint(value);
+    } else {
       return std::nullopt;
     }
 
-    std::int64_t sint = yyjson_get_sint(value);
-
     if (ctx.has_option(option::check_range)) {
       if (sint > static_cast<std::int64_t>(std::numeric_limits<T>::max())) {
         return std::nullopt;
@@ -278,12 +644,19 @@ std::optional<T> get_integer(yyjson_val *value, const context &ctx) {
     }
     return static_cast<T>(sint);
   } else {
-    if (!yyjson_is_uint(value)) {
+    std::uint64_t uint = 0;
+    if (yyjson_is_raw(value)) {
+      auto parsed = parse_raw<std::uint64_t>(value);
+      if (!parsed.has_value()) {
+        return std::nullopt;
+      }
+      uint = *parsed;
+    } else if (yyjson_is_uint(value)) {
+      uint = yyjson_get_uint(value);
+    } else {
       return std::nullopt;
     }
 
-    std::uint64_t uint = yyjson_get_uint(value);
-
     if (ctx.has_option(option::check_range)) {
       if (uint > static_cast<std::uint64_t>(std::numeric_limits<T>::max())) {
         return std::nullopt;
@@ -293,6 +666,115 @@ std::optional<T> get_integer(yyjson_val *value, const context &ctx) {
   }
 }
 
+template <typename T>
+std::optional<T> get_real(yyjson_val *value, const context &ctx) {
+  double real = 0;
+  if (yyjson_is_raw(value)) {
+    std::string_view text(yyjson_get_raw(value), yyjson_get_len(value));
+    if (ctx.has_option(option::strict_real) &&
+        text.find_first_of(".eE") == std::string_view::npos) {
+      return std::nullopt;
+    }
+    auto parsed = parse_raw<double>(value);
+    if (!parsed.has_value()) {
+      return std::nullopt;
+    }
+    real = *parsed;
+  } else if (yyjson_is_real(value)) {
+    real = yyjson_get_real(value);
+  } else if (ctx.has_option(option::strict_real)) {
+    return std::nullopt;
+  } else if (yyjson_is_uint(value)) {
+    // try uint first to get a better range
+    real = static_cast<double>(yyjson_get_uint(value));
+  } else if (yyjson_is_int(value)) {
+    real = static_cast<double>(yyjson_get_sint(value));
+  } else {
+    return std::nullopt;
+  }
+
+  if constexpr (sizeof(T) < sizeof(double)) {
+    // converting a value outside of the range of T is undefined, so round it
+    // like IEEE 754 does: to the largest T up to half an ulp past it, and to
+    // infinity (or an error with `check_range`) beyond that
+    constexpr auto max = static_cast<double>(std::numeric_limits<T>::max());
+    constexpr auto ulp =
+        max / static_cast<double>(
+                  (std::uint64_t{1} << std::numeric_limits<T>::digits) - 1);
+    constexpr auto overflow = max + ulp / 2;
+    if (real >= overflow || real <= -overflow) {
+      if (ctx.has_option(option::check_range)) {
+        return std::nullopt;
+      }
+      return real > 0 ? std::numeric_limits<T>::infinity()
+                      : -std::numeric_limits<T>::infinity();
+    }
+    if (real > max || real < -max) {
+      return real > 0 ? std::numeric_limits<T>::max()
+                      : std::numeric_limits<T>::lowest();
+    }
+  }
+  return static_cast<T>(real);
+}
+
+template <typename V, std::size_t I>
+std::optional<V> get_alternative_at(yyjson_val *value, const context &ctx) {
+  auto alternative = deserialize(
+      std::type_identity<std::variant_alternative_t<I, V>>{}, value, ctx);
+  if (!alternative.has_value()) {
+    return std::nullopt;
+  }
+  return V(std::in_place_index<I>, std::move(*alternative));
+}
+
+template <typename V>
+std::optional<V> get_alternative(std::size_t index, yyjson_val *value,
+                                 const context &ctx) {
+  using get_fn = std::optional<V> (*)(yyjson_val *, const context &);
+  constexpr auto table = []<std::size_t... I>(std::index_sequence<I...>) {
+    return std::array<get_fn, sizeof...(I)>{&get_alternative_at<V, I>...};
+  }(std::make_index_sequence<std::variant_size_v<V>>{});
+
+  return table[index](value, ctx);
+}
+
+template <typename T, std::size_t I>
+using field_type = std::remove_cv_t<boost::pfr::tuple_element_t<I, T>>;
+
+template <typename T, std::size_t I>
+std::optional<field_type<T, I>> get_field(ordered_members &members,
+                                          const context &ctx) {
+  using F = field_type<T, I>;
+
+  auto *inner = find_field<T, I>(members);
+  if constexpr (std::is_default_constructible_v<F>) {
+    if (!inner && default_missing_fields<T>) {
+      return F{};
+    }
+  }
+  return deserialize(std::type_identity<F>{}, inner, ctx);
+}
+
+/// Aggregate-initializes a `T` that isn't default-constructible. Fields are
+/// decoded before `T` exists, so they are moved into place.
+template <typename T, std::size_t... I>
+std::optional<T> construct_aggregate(yyjson_val *value, const context &ctx,
+                                     std::index_sequence<I...>) {
+  if (!yyjson_is_obj(value)) {
+    return std::nullopt;
+  }
+
+  std::tuple<std::optional<field_type<T, I>>...> fields;
+  ordered_members members(value);
+  bool ok =
+      ((std::get<I>(fields) = get_field<T, I>(members, ctx)).has_value() &&
+       ...);
+  if (!ok) {
+    return std::nullopt;
+  }
+  return T{*std::move(std::get<I>(fields))...};
+}
+
 } // namespace detail
 
 } // namespace miniser::deser
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+// Base64 (RFC 4648, with padding) and lowercase hex codecs for `bytes`.
+//
+// With SSSE3 (e.g. `-mssse3` or `-march=native`), base64 is encoded and
+// decoded 12 bytes at a time and hex is encoded 16 bytes at a time. The scalar
+// code handles the rest and is used on other targets.
+namespace miniser::detail::binary {
+
+inline constexpr std::string_view base64_alphabet =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+inline constexpr std::string_view hex_alphabet = "0123456789abcdef";
+
+/// Value of each character in base64 (or hex), `-1` if it's invalid
+template <std::size_t N>
+constexpr std::array<std::int8_t, 256> decoding_table(std::string_view chars) {
+  std::array<std::int8_t, 256> table{};
+  table.fill(-1);
+  for (std::size_t i = 0; i < N; i++) {
+    table[static_cast<unsigned char>(chars[i])] = static_cast<std::int8_t>(i);
+  }
+  return table;
+}
+
+inline constexpr auto base64_table = decoding_table<64>(base64_alphabet);
+inline constexpr auto hex_table = [] {
+  auto table = decoding_table<16>(hex_alphabet);
+  for (int i = 0; i < 6; i++) {
+    table['A' + i] = static_cast<std::int8_t>(10 + i);
+  }
+  return table;
+}();
+
+constexpr std::size_t base64_encoded_size(std::size_t n) {
+  return (n + 2) / 3 * 4;
+}
+
+/// Size of the decoded base64 `text` (or nothing if its length is invalid)
+inline std::optional<std::size_t> base64_decoded_size(std::string_view text) {
+  if (text.size() % 4 != 0) {
+    return std::nullopt;
+  }
+  std::size_t padding = 0;
+  if (text.ends_with("==")) {
+    padding = 2;
+  } else if (text.ends_with('=')) {
+    padding = 1;
+  }
+  return text.size() / 4 * 3 - padding;
+}
+
+#if defined(__SSSE3__)
+
+/// Encodes 12 bytes from `in` (16 are read) into 16 characters.
+inline void base64_encode_block(const std::uint8_t *in, char *out) {
+  auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+  // every 32-bit lane gets the 3 bytes it encodes (as bytes 1, 0, 2, 1)
+  v = _mm_shuffle_epi8(
+      v, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+  // move each 6-bit index into its own byte
+  auto t0 = _mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00));
+  auto t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+  auto t2 = _mm_and_si128(v, _mm_set1_epi32(0x003f03f0));
+  auto t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+  auto indices = _mm_or_si128(t1, t3);
+
+  // the character is the index plus an offset that depends on its range:
+  // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+  auto range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+  auto upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+  const auto offsets = _mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+  auto chars = _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out), chars);
+}
+
+/// Decodes 16 characters into 12 bytes (16 are written). Returns `false` if
+/// a character isn't part of the alphabet (including padding).
+inline bool base64_decode_block(const char *in, std::uint8_t *out) {
+  auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+  const auto mask_2f = _mm_set1_epi8(0x2f);
+  auto hi_nibbles = _mm_and_si128(_mm_srli_epi32(v, 4), mask_2f);
+  auto lo_nibbles = _mm_and_si128(v, mask_2f);
+
+  // every invalid character has a bit set in both lookups
+  const auto lut_lo =
+      _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                    0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+  const auto lut_hi =
+      _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10,
+                    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+  auto lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+  auto hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+  auto invalid = _mm_and_si128(lo, hi);
+  if (_mm_movemask_epi8(_mm_cmpeq_epi8(invalid, _mm_setzero_si128())) !=
+      0xFFFF) {
+    return false;
+  }
+
+  // characters to indices, by an offset that depends on the high nibble ('/'
+  // shares it with '+')
+  const auto lut_roll =
+      _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  auto eq_2f = _mm_cmpeq_epi8(v, mask_2f);
+  auto roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+  v = _mm_add_epi8(v, roll);
+
+  // pack 4 6-bit indices into 3 bytes per 32-bit lane
+  v = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+  v = _mm_madd_epi16(v, _mm_set1_epi32(0x00011000));
+  v = _mm_shuffle_epi8(v, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13,
+                                        12, -1, -1, -1, -1));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out), v);
+  return true;
+}
+
+/// Encodes 16 bytes into 32 characters.
+inline void hex_encode_block(const std::uint8_t *in, char *out) {
+  auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+  const auto mask = _mm_set1_epi8(0x0f);
+  const auto digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                    '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+  auto hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+  auto lo = _mm_shuffle_epi8(digits, _mm_and_si128(v, mask));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_unpacklo_epi8(hi, lo));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16),
+                   _mm_unpackhi_epi8(hi, lo));
+}
+
+#endif
+
+/// Writes `base64_encoded_size(n)` characters to `out`.
+inline void base64_encode(const std::uint8_t *in, std::size_t n, char *out) {
+  std::size_t i = 0;
+#if defined(__SSSE3__)
+  for (; i + 16 <= n; i += 12, out += 16) {
+    base64_encode_block(in + i, out);
+  }
+#endif
+  for (; i + 3 <= n; i += 3) {
+    std::uint32_t group = (std::uint32_t{in[i]} << 16) |
+                          (std::uint32_t{in[i + 1]} << 8) | in[i + 2];
+    *out++ = base64_alphabet[(group >> 18) & 0x3f];
+    *out++ = base64_alphabet[(group >> 12) & 0x3f];
+    *out++ = base64_alphabet[(group >> 6) & 0x3f];
+    *out++ = base64_alphabet[group & 0x3f];
+  }
+  if (i < n) {
+    std::uint32_t group = std::uint32_t{in[i]} << 16;
+    if (i + 1 < n) {
+      group |= std::uint32_t{in[i + 1]} << 8;
+    }
+    *out++ = base64_alphabet[(group >> 18) & 0x3f];
+    *out++ = base64_alphabet[(group >> 12) & 0x3f];
+    *out++ = i + 1 < n ? base64_alphabet[(group >> 6) & 0x3f] : '=';
+    *out++ = '=';
+  }
+}
+
+/// Decodes `text` into `base64_decoded_size(text)` bytes at `out`. Returns
+/// `false` if `text` isn't valid base64.
+inline bool base64_decode(std::string_view text, std::uint8_t *out) {
+  if (text.size() % 4 != 0) {
+    return false;
+  }
+  auto size = text.size();
+  const char *in = text.data();
+  std::size_t i = 0;
+#if defined(__SSSE3__)
+  // the last two groups are decoded by the scalar code: the last one may be
+  // padded, and together they leave room for the 4 extra bytes written by
+  // each block
+  for (; i + 16 + 8 <= size; i += 16, out += 12) {
+    if (!base64_decode_block(in + i, out)) {
+      return false;
+    }
+  }
+#endif
+  for (; i < size; i += 4) {
+    auto a = base64_table[static_cast<unsigned char>(in[i])];
+    auto b = base64_table[static_cast<unsigned char>(in[i + 1])];
+    auto c = base64_table[static_cast<unsigned char>(in[i + 2])];
+    auto d = base64_table[static_cast<unsigned char>(in[i + 3])];
+    if (a < 0 || b < 0) {
+      return false;
+    }
+
+    bool last = i + 4 == size;
+    std::uint32_t group = (static_cast<std::uint32_t>(a) << 18) |
+                          (static_cast<std::uint32_t>(b) << 12);
+    *out++ = static_cast<std::uint8_t>(group >> 16);
+    if (last && in[i + 2] == '=' && in[i + 3] == '=') {
+      break;
+    }
+    if (c < 0) {
+      return false;
+    }
+    group |= static_cast<std::uint32_t>(c) << 6;
+    *out++ = static_cast<std::uint8_t>(group >> 8);
+    if (last && in[i + 3] == '=') {
+      break;
+    }
+    if (d < 0) {
+      return false;
+    }
+    group |= static_cast<std::uint32_t>(d);
+    *out++ = static_cast<std::uint8_t>(group);
+  }
+  return true;
+}
+
+constexpr std::size_t hex_encoded_size(std::size_t n) { return n * 2; }
+
+inline std::optional<std::size_t> hex_decoded_size(std::string_view text) {
+  if (text.size() % 2 != 0) {
+    return std::nullopt;
+  }
+  return text.size() / 2;
+}
+
+/// Writes `hex_encoded_size(n)` characters to `out`.
+inline void hex_encode(const std::uint8_t *in, std::size_t n, char *out) {
+  std::size_t i = 0;
+#if defined(__SSSE3__)
+  for (; i + 16 <= n; i += 16, out += 32) {
+    hex_encode_block(in + i, out);
+  }
+#endif
+  for (; i < n; i++) {
+    *out++ = hex_alphabet[in[i] >> 4];
+    *out++ = hex_alphabet[in[i] & 0xf];
+  }
+}
+
+/// Decodes `text` (upper- or lowercase) into `hex_decoded_size(text)` bytes
+/// at `out`. Returns `false` if `text` isn't valid hex.
+inline bool hex_decode(std::string_view text, std::uint8_t *out) {
+  if (text.size() % 2 != 0) {
+    return false;
+  }
+  for (std::size_t i = 0; i < text.size(); i += 2) {
+    auto hi = hex_table[static_cast<unsigned char>(text[i])];
+    auto lo = hex_table[static_cast<unsigned char>(text[i + 1])];
+    if (hi < 0 || lo < 0) {
+      return false;
+    }
+    *out++ = static_cast<std::uint8_t>((hi << 4) | lo);
+  }
+  return true;
+}
+
+} // namespace miniser::detail::binary
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <boost/pfr.hpp>
+#include <string_view>
+#include <utility>
 
 namespace miniser {
 
@@ -137,6 +141,39 @@ template <std::size_t I, rename_fields_snake T>
 inline constexpr std::string_view name_of_field<I, T> =
     casing::snake::stored_name_of_field<I, T>.data();
 
+/// Names of all fields in `T` (in declaration order)
+template <class T>
+inline constexpr auto field_names =
+    []<std::size_t... I>(std::index_sequence<I...>) {
+      return std::array<std::string_view, sizeof...(I)>{
+          name_of_field<I, T>...};
+    }(std::make_index_sequence<boost::pfr::tuple_size_v<T>>{});
+
+/// Indices of the fields in `T`, ordered by their names (byte-wise)
+template <class T>
+inline constexpr auto sorted_field_order = [] {
+  std::array<std::size_t, field_names<T>.size()> order{};
+  for (std::size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [](std::size_t a, std::size_t b) {
+    return field_names<T>[a] < field_names<T>[b];
+  });
+  return order;
+}();
+
+/// Index of the field named `key` in `T` or the number of fields if there's
+/// no such field.
+template <class T>
+constexpr std::size_t field_index(std::string_view key) noexcept {
+  for (std::size_t i = 0; i < field_names<T>.size(); i++) {
+    if (field_names<T>[i] == key) {
+      return i;
+    }
+  }
+  return field_names<T>.size();
+}
+
 } // namespace detail
 
 } // namespace miniser
@@ -0,0 +1,332 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace miniser {
+
+/// Limits enforced while scanning untrusted input
+struct limits {
+  /// Maximum nesting of arrays and objects
+  std::size_t max_depth = 64;
+  /// Maximum number of array elements and object members in the document
+  std::size_t max_elements = std::numeric_limits<std::size_t>::max();
+  /// Maximum length (in bytes, before unescaping) of any string or key
+  std::size_t max_string_length = std::numeric_limits<std::size_t>::max();
+};
+
+namespace detail {
+
+inline int hex_value(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+/// A forward-only scanner over (standard) JSON text.
+///
+/// It only checks the syntax of the tokens it consumes and doesn't decode
+/// anything. Every function returns `false` as soon as the input is invalid
+/// or exceeds the limits.
+class scanner {
+public:
+  explicit scanner(std::string_view input, limits lims = {})
+      : input_(input), limits_(lims) {}
+
+  [[nodiscard]] std::size_t position() const { return this->pos_; }
+  [[nodiscard]] std::string_view input() const { return this->input_; }
+
+  /// Returns the next non-whitespace character without consuming it (or '\0'
+  /// at the end of the input).
+  char peek() {
+    this->skip_ws();
+    if (this->pos_ >= this->input_.size()) {
+      return '\0';
+    }
+    return this->input_[this->pos_];
+  }
+
+  /// Consumes `c` if it's the next non-whitespace character.
+  bool consume(char c) {
+    if (this->peek() != c) {
+      return false;
+    }
+    this->pos_++;
+    return true;
+  }
+
+  /// Only whitespace is left.
+  bool at_end() { return this->peek() == '\0' && this->pos_ >= size(); }
+
+  /// Counts an array element or object member against the limits.
+  bool count_element() {
+    return ++this->elements_ <= this->limits_.max_elements;
+  }
+
+  /// Checks that a container at `depth` may be entered.
+  [[nodiscard]] bool can_enter(std::size_t depth) const {
+    return depth < this->limits_.max_depth;
+  }
+
+  /// Scans a string and stores its contents (without quotes, still escaped)
+  /// in `raw`.
+  bool scan_string(std::string_view &raw) {
+    if (!this->consume('"')) {
+      return false;
+    }
+    auto start = this->pos_;
+    while (this->pos_ < size()) {
+      auto c = static_cast<unsigned char>(this->input_[this->pos_]);
+      if (c == '"') {
+        raw = this->input_.substr(start, this->pos_ - start);
+        this->pos_++;
+        return raw.size() <= this->limits_.max_string_length;
+      }
+      if (c < 0x20) {
+        return false;
+      }
+      if (c == '\\') {
+        if (!this->scan_escape()) {
+          return false;
+        }
+        continue;
+      }
+      this->pos_++;
+    }
+    return false;
+  }
+
+  /// Scans a number and stores its text in `raw`.
+  bool scan_number(std::string_view &raw) {
+    this->skip_ws();
+    auto start = this->pos_;
+    this->take('-');
+    if (this->take('0')) {
+      // no leading zeros
+    } else if (!this->take_digits()) {
+      return false;
+    }
+    if (this->take('.') && !this->take_digits()) {
+      return false;
+    }
+    if (this->take('e') || this->take('E')) {
+      if (!this->take('+')) {
+        this->take('-');
+      }
+      if (!this->take_digits()) {
+        return false;
+      }
+    }
+    raw = this->input_.substr(start, this->pos_ - start);
+    return true;
+  }
+
+  /// Scans `true`, `false` or `null`.
+  bool scan_literal(std::string_view literal) {
+    this->skip_ws();
+    if (this->input_.substr(this->pos_, literal.size()) != literal) {
+      return false;
+    }
+    this->pos_ += literal.size();
+    return true;
+  }
+
+  /// Scans over any value at `depth`.
+  bool skip_value(std::size_t depth) {
+    std::string_view raw;
+    switch (this->peek()) {
+    case '"':
+      return this->scan_string(raw);
+    case 't':
+      return this->scan_literal("true");
+    case 'f':
+      return this->scan_literal("false");
+    case 'n':
+      return this->scan_literal("null");
+    case '[':
+      return this->skip_container(depth, ']');
+    case '{':
+      return this->skip_container(depth, '}');
+    default:
+      return this->scan_number(raw);
+    }
+  }
+
+private:
+  [[nodiscard]] std::size_t size() const { return this->input_.size(); }
+
+  void skip_ws() {
+    while (this->pos_ < size()) {
+      char c = this->input_[this->pos_];
+      if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+        return;
+      }
+      this->pos_++;
+    }
+  }
+
+  bool take(char c) {
+    if (this->pos_ < size() && this->input_[this->pos_] == c) {
+      this->pos_++;
+      return true;
+    }
+    return false;
+  }
+
+  bool take_digits() {
+    auto start = this->pos_;
+    while (this->pos_ < size() && this->input_[this->pos_] >= '0' &&
+           this->input_[this->pos_] <= '9') {
+      this->pos_++;
+    }
+    return this->pos_ != start;
+  }
+
+  bool scan_escape() {
+    // skip the backslash
+    this->pos_++;
+    if (this->pos_ >= size()) {
+      return false;
+    }
+    switch (this->input_[this->pos_++]) {
+    case '"':
+    case '\\':
+    case '/':
+    case 'b':
+    case 'f':
+    case 'n':
+    case 'r':
+    case 't':
+      return true;
+    case 'u':
+      for (int i = 0; i < 4; i++, this->pos_++) {
+        if (this->pos_ >= size() || hex_value(this->input_[this->pos_]) < 0) {
+          return false;
+        }
+      }
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  bool skip_container(std::size_t depth, char close) {
+    if (!this->can_enter(depth)) {
+      return false;
+    }
+    // skip the opening bracket
+    this->pos_++;
+    if (this->consume(close)) {
+      return true;
+    }
+    do {
+      if (!this->count_element()) {
+        return false;
+      }
+      if (close == '}') {
+        std::string_view key;
+        if (!this->scan_string(key) || !this->consume(':')) {
+          return false;
+        }
+      }
+      if (!this->skip_value(depth + 1)) {
+        return false;
+      }
+    } while (this->consume(','));
+    return this->consume(close);
+  }
+
+  std::string_view input_;
+  std::size_t pos_ = 0;
+  limits limits_;
+  std::size_t elements_ = 0;
+};
+
+/// Unescapes the contents of a string that was validated by `scanner`.
+inline std::string unescape(std::string_view raw) {
+  std::string out;
+  out.reserve(raw.size());
+
+  auto read_hex4 = [&](std::size_t at) {
+    std::uint32_t cp = 0;
+    for (std::size_t i = at; i < at + 4 && i < raw.size(); i++) {
+      cp = (cp << 4) | static_cast<std::uint32_t>(hex_value(raw[i]));
+    }
+    return cp;
+  };
+  auto put_utf8 = [&](std::uint32_t cp) {
+    if (cp < 0x80) {
+      out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+      out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+      out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+      out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+      out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+      out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+      out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+  };
+
+  for (std::size_t i = 0; i < raw.size(); i++) {
+    if (raw[i] != '\\' || i + 1 >= raw.size()) {
+      out.push_back(raw[i]);
+      continue;
+    }
+    char c = raw[++i];
+    switch (c) {
+    case 'b':
+      out.push_back('\b');
+      break;
+    case 'f':
+      out.push_back('\f');
+      break;
+    case 'n':
+      out.push_back('\n');
+      break;
+    case 'r':
+      out.push_back('\r');
+      break;
+    case 't':
+      out.push_back('\t');
+      break;
+    case 'u': {
+      auto cp = read_hex4(i + 1);
+      i += 4;
+      // combine surrogate pairs
+      if (cp >= 0xD800 && cp < 0xDC00 && i + 6 < raw.size() &&
+          raw[i + 1] == '\\' && raw[i + 2] == 'u') {
+        auto low = read_hex4(i + 3);
+        if (low >= 0xDC00 && low < 0xE000) {
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+          i += 6;
+        }
+      }
+      put_utf8(cp);
+      break;
+    }
+    default:
+      out.push_back(c);
+      break;
+    }
+  }
+  return out;
+}
+
+} // namespace detail
+
+} // namespace miniser
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <miniser/bytes.hpp>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace miniser {
+
+/// Fields that are left out when serializing an aggregate
+enum class skip : unsigned {
+  none = 0,
+  /// Disengaged `std::optional`s
+  null = (1 << 0),
+  /// Numbers equal to zero and `false`
+  default_value = (1 << 1),
+  /// Empty strings, `std::vector`s and `bytes`
+  empty = (1 << 2),
+  all = null | default_value | empty,
+};
+
+constexpr skip operator|(skip a, skip b) {
+  return static_cast<skip>(static_cast<std::underlying_type_t<skip>>(a) |
+                           static_cast<std::underlying_type_t<skip>>(b));
+}
+
+template <class T> inline constexpr skip skip_fields = skip::none;
+
+/// If set, missing fields of `T` are value-initialized instead of failing the
+/// deserialization. This is the default for types that skip fields.
+template <class T>
+inline constexpr bool default_missing_fields = skip_fields<T> != skip::none;
+
+namespace detail {
+
+template <typename T> struct is_vector : std::false_type {};
+template <typename T> struct is_vector<std::vector<T>> : std::true_type {};
+
+template <typename T> struct is_optional : std::false_type {};
+template <typename T> struct is_optional<std::optional<T>> : std::true_type {};
+
+constexpr bool has_skip(skip set, skip s) {
+  return (static_cast<std::underlying_type_t<skip>>(set) &
+          static_cast<std::underlying_type_t<skip>>(s)) != 0;
+}
+
+/// Whether `value` (a field of `T`) is left out when serializing `T`
+template <typename T, typename F> bool skip_field(const F &value) {
+  constexpr auto policy = skip_fields<T>;
+  if constexpr (policy == skip::none) {
+    return false;
+  } else if constexpr (is_optional<F>::value) {
+    return has_skip(policy, skip::null) && !value.has_value();
+  } else if constexpr (std::is_arithmetic_v<F>) {
+    return has_skip(policy, skip::default_value) && value == F{};
+  } else if constexpr (is_vector<F>::value || is_bytes<F>::value ||
+                       std::is_same_v<F, std::string> ||
+                       std::is_same_v<F, std::string_view>) {
+    return has_skip(policy, skip::empty) && value.empty();
+  } else {
+    return false;
+  }
+}
+
+} // namespace detail
+
+} // namespace miniser
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <miniser/detail/scanner.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include <yyjson.h>
+
+namespace miniser::detail {
+
+/// The text a document was read from, to get the bytes of its values (e.g.
+/// for `raw_json`).
+///
+/// yyjson doesn't keep the positions of values, so the text is scanned
+/// alongside the document up to the value that's looked up. Only the
+/// containers on the way to it are entered, everything else is skipped
+/// without being recorded. Values of a document are stored in the order of
+/// the text, so lookups in that order (like those of `deserialize`) resume
+/// where the previous one stopped and scan the text once. A lookup of a
+/// value before that starts over.
+class source_text {
+public:
+  source_text(std::string_view text, yyjson_doc *doc)
+      : text_(text), doc_(doc), sc_(text) {}
+
+  /// The text of `value`. Nothing if it isn't part of the document or if the
+  /// text before it can't be scanned (e.g. because it uses extensions like
+  /// comments or is nested too deeply).
+  std::optional<std::string_view> find(yyjson_val *value) {
+    if (this->failed_ || !value) {
+      return std::nullopt;
+    }
+    if (auto text = this->advance_to(value)) {
+      return text;
+    }
+    if (this->failed_ || this->at_start()) {
+      return std::nullopt;
+    }
+    // the value may be before the current position
+    this->restart();
+    return this->advance_to(value);
+  }
+
+private:
+  /// An array or object that's being scanned
+  struct frame {
+    bool is_obj;
+    bool first = true;
+    yyjson_arr_iter arr{};
+    yyjson_obj_iter obj{};
+    /// The first value after the container (`nullptr` if there's none)
+    yyjson_val *end;
+  };
+
+  [[nodiscard]] bool at_start() const {
+    return this->sc_.position() == 0 && this->frames_.empty() &&
+           this->next_ == yyjson_doc_get_root(this->doc_);
+  }
+
+  void restart() {
+    this->sc_ = scanner(this->text_);
+    this->frames_.clear();
+    this->next_ = yyjson_doc_get_root(this->doc_);
+    this->next_end_ = nullptr;
+  }
+
+  std::optional<std::string_view> fail() {
+    this->failed_ = true;
+    return std::nullopt;
+  }
+
+  /// Whether `a` comes before `b` in the document
+  static bool before(yyjson_val *a, yyjson_val *b) {
+    return std::less<yyjson_val *>{}(a, b);
+  }
+
+  /// Scans up to `target` and returns its text. Nothing if the document ends
+  /// or a value after `target` comes first.
+  std::optional<std::string_view> advance_to(yyjson_val *target) {
+    while (true) {
+      if (!this->next_ && !this->next_child()) {
+        return std::nullopt;
+      }
+      if (!this->next_) {
+        continue;
+      }
+
+      auto *value = this->next_;
+      auto *end = this->next_end_;
+      if (before(target, value)) {
+        return std::nullopt;
+      }
+      this->next_ = nullptr;
+      auto depth = this->frames_.size();
+      if (value == target) {
+        this->sc_.peek();
+        auto start = this->sc_.position();
+        if (!this->sc_.skip_value(depth)) {
+          return this->fail();
+        }
+        return this->text_.substr(start, this->sc_.position() - start);
+      }
+
+      bool contains = !end || before(target, end);
+      if (contains && (yyjson_is_arr(value) || yyjson_is_obj(value))) {
+        bool is_obj = yyjson_is_obj(value);
+        if (!this->sc_.can_enter(depth) ||
+            !this->sc_.consume(is_obj ? '{' : '[')) {
+          return this->fail();
+        }
+        frame f{.is_obj = is_obj, .end = end};
+        if (is_obj) {
+          f.obj = yyjson_obj_iter_with(value);
+        } else {
+          f.arr = yyjson_arr_iter_with(value);
+        }
+        this->frames_.push_back(f);
+      } else if (!this->sc_.skip_value(depth)) {
+        return this->fail();
+      }
+    }
+  }
+
+  /// Moves to the next child of the innermost container, or out of it if
+  /// it has no more. Returns `false` at the end of the document (or if the
+  /// text doesn't match).
+  bool next_child() {
+    if (this->frames_.empty() || this->failed_) {
+      return false;
+    }
+    auto &f = this->frames_.back();
+    yyjson_val *child = nullptr;
+    yyjson_val *following = nullptr;
+    if (f.is_obj) {
+      auto *key = yyjson_obj_iter_next(&f.obj);
+      if (key) {
+        auto peek = f.obj;
+        following = yyjson_obj_iter_next(&peek);
+        child = yyjson_obj_iter_get_val(key);
+      }
+    } else {
+      child = yyjson_arr_iter_next(&f.arr);
+      if (child) {
+        auto peek = f.arr;
+        following = yyjson_arr_iter_next(&peek);
+      }
+    }
+
+    if (!child) {
+      if (!this->sc_.consume(f.is_obj ? '}' : ']')) {
+        this->fail();
+        return false;
+      }
+      this->frames_.pop_back();
+      return true;
+    }
+
+    std::string_view key;
+    bool ok = f.first || this->sc_.consume(',');
+    if (ok && f.is_obj) {
+      ok = this->sc_.scan_string(key) && this->sc_.consume(':');
+    }
+    if (!ok) {
+      this->fail();
+      return false;
+    }
+    f.first = false;
+    this->next_ = child;
+    this->next_end_ = following ? following : f.end;
+    return true;
+  }
+
+  std::string_view text_;
+  yyjson_doc *doc_;
+  scanner sc_;
+  std::vector<frame> frames_;
+  /// The value at the position of the scanner (`nullptr` if it's the next
+  /// child of the innermost container) and the first value after it
+  yyjson_val *next_ = yyjson_doc_get_root(this->doc_);
+  yyjson_val *next_end_ = nullptr;
+  bool failed_ = false;
+};
+
+} // namespace miniser::detail
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <variant>
+
+namespace miniser {
+
+/// How the alternative of a `std::variant` is identified in JSON
+enum class tagging {
+  /// `{"<tag>": <value>}`
+  external,
+  /// `{"type": "<tag>", ...fields of value}` (alternatives must be objects)
+  internal,
+  /// `{"type": "<tag>", "content": <value>}`
+  adjacent,
+};
+
+namespace detail {
+
+template <typename T> consteval auto raw_type_name() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  return std::string_view(__FUNCSIG__);
+#else
+  return std::string_view(__PRETTY_FUNCTION__);
+#endif
+}
+
+// The function signature of `raw_type_name<int>` tells us how much to strip
+// around the type name.
+inline constexpr std::size_t type_name_prefix =
+    raw_type_name<int>().find("int");
+inline constexpr std::size_t type_name_suffix =
+    raw_type_name<int>().size() - type_name_prefix - 3;
+
+/// Unqualified name of `T` (without namespaces and `struct`/`class`)
+consteval std::string_view unqualified_type_name(std::string_view full) {
+  full = full.substr(type_name_prefix,
+                     full.size() - type_name_prefix - type_name_suffix);
+  for (std::string_view kw : {"struct ", "class ", "enum ", "union "}) {
+    if (full.starts_with(kw)) {
+      full.remove_prefix(kw.size());
+    }
+  }
+  // only strip namespaces outside of template arguments
+  auto end = full.find('<');
+  auto sep = full.substr(0, end).rfind("::");
+  if (sep != std::string_view::npos) {
+    full.remove_prefix(sep + 2);
+  }
+  return full;
+}
+
+template <typename T> consteval auto stored_type_name() {
+  constexpr auto name = unqualified_type_name(raw_type_name<T>());
+  auto res = std::array<char, name.size() + 1>{};
+  for (std::size_t i = 0; i < name.size(); i++) {
+    res[i] = name[i];
+  }
+  return res;
+}
+
+template <typename T>
+inline constexpr auto stored_type_name_v = stored_type_name<T>();
+
+} // namespace detail
+
+/// Tagging strategy for the variant `V`
+template <class V> inline constexpr tagging tag_variant = tagging::external;
+
+/// Key of the tag for internally and adjacently tagged variants
+template <class V> inline constexpr std::string_view variant_tag_field = "type";
+
+/// Key of the value for adjacently tagged variants
+template <class V>
+inline constexpr std::string_view variant_content_field = "content";
+
+/// Tag of `T` when used as an alternative (defaults to the unqualified name)
+template <class T>
+inline constexpr std::string_view variant_tag =
+    detail::stored_type_name_v<T>.data();
+
+namespace detail {
+
+template <typename V> struct variant_tags;
+
+template <typename... Ts> struct variant_tags<std::variant<Ts...>> {
+  static constexpr std::array<std::string_view, sizeof...(Ts)> names{
+      variant_tag<Ts>...};
+
+  static constexpr bool unique = [] {
+    for (std::size_t i = 0; i < names.size(); i++) {
+      for (std::size_t j = i + 1; j < names.size(); j++) {
+        if (names[i] == names[j]) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }();
+  static_assert(unique, "the alternatives of a variant need distinct tags "
+                        "(specialize miniser::variant_tag<T> for types with "
+                        "the same unqualified name)");
+
+  /// Index of the alternative tagged `tag` or `sizeof...(Ts)` if none is.
+  static constexpr std::size_t find(std::string_view tag) noexcept {
+    for (std::size_t i = 0; i < names.size(); i++) {
+      if (names[i] == tag) {
+        return i;
+      }
+    }
+    return names.size();
+  }
+};
+
+} // namespace detail
+
+} // namespace miniser
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <miniser/detail/scanner.hpp>
+#include <miniser/miniser.hpp>
+
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace miniser {
+
+namespace detail {
+
+/// Removes the next reference token from a JSON pointer (starting with '/')
+/// and stores it unescaped in `token`.
+inline bool next_token(std::string_view &pointer, std::string &token) {
+  if (!pointer.starts_with('/')) {
+    return false;
+  }
+  pointer.remove_prefix(1);
+  auto raw = pointer.substr(0, pointer.find('/'));
+  pointer.remove_prefix(raw.size());
+
+  token.clear();
+  for (std::size_t i = 0; i < raw.size(); i++) {
+    if (raw[i] != '~') {
+      token.push_back(raw[i]);
+      continue;
+    }
+    if (i + 1 >= raw.size()) {
+      return false;
+    }
+    switch (raw[++i]) {
+    case '0':
+      token.push_back('~');
+      break;
+    case '1':
+      token.push_back('/');
+      break;
+    default:
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Parses an array index (no sign or leading zeros)
+inline bool parse_index(std::string_view token, std::size_t &index) {
+  if (token.empty() || (token.size() > 1 && token[0] == '0')) {
+    return false;
+  }
+  const auto *end = token.data() + token.size();
+  auto res = std::from_chars(token.data(), end, index);
+  return res.ec == std::errc{} && res.ptr == end;
+}
+
+/// Advances `sc` to the value referenced by `pointer` and stores the depth of
+/// that value in `depth`.
+inline bool find_pointer(scanner &sc, std::string_view pointer,
+                         std::size_t &depth) {
+  std::string token;
+  for (depth = 0; !pointer.empty(); depth++) {
+    if (!next_token(pointer, token)) {
+      return false;
+    }
+
+    char c = sc.peek();
+    if ((c != '{' && c != '[') || !sc.can_enter(depth)) {
+      return false;
+    }
+    sc.consume(c);
+    if (c == '{') {
+      bool found = false;
+      do {
+        std::string_view key;
+        if (!sc.count_element() || !sc.scan_string(key) || !sc.consume(':')) {
+          return false;
+        }
+        if (key.find('\\') == std::string_view::npos
+                ? key == token
+                : unescape(key) == token) {
+          // like yyjson_obj_get, the first occurrence of a key is used
+          found = true;
+          break;
+        }
+        if (!sc.skip_value(depth + 1)) {
+          return false;
+        }
+      } while (sc.consume(','));
+      if (!found) {
+        return false;
+      }
+    } else {
+      std::size_t index = 0;
+      if (!parse_index(token, index) || sc.peek() == ']') {
+        return false;
+      }
+      for (std::size_t i = 0; i < index; i++) {
+        if (!sc.count_element() || !sc.skip_value(depth + 1) ||
+            !sc.consume(',')) {
+          return false;
+        }
+      }
+      if (!sc.count_element()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace detail
+
+/// Deserializes the value referenced by a JSON pointer (RFC 6901), like
+/// `extract<std::string>(json, "/meta/tenant")`.
+///
+/// The input is only scanned up to the end of the referenced value, without
+/// building a document, and only that value is parsed and converted. The rest
+/// of the input isn't checked. Only standard JSON nested at most
+/// `limits{}.max_depth` levels is accepted.
+template <typename T>
+std::optional<T> extract(std::string_view str, std::string_view pointer,
+                         const deser::context &ctx = {},
+                         yyjson_read_flag flags = 0) {
+  detail::scanner sc(str);
+  std::size_t depth = 0;
+  if (!detail::find_pointer(sc, pointer, depth)) {
+    return std::nullopt;
+  }
+
+  sc.peek(); // skips whitespace
+  auto start = sc.position();
+  if (!sc.skip_value(depth)) {
+    return std::nullopt;
+  }
+  return deserialize<T>(str.substr(start, sc.position() - start), ctx, flags);
+}
+
+} // namespace miniser
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <miniser/stream.hpp>
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace miniser {
+
+/// Incrementally hashes data passed to `update` in arbitrary pieces.
+template <typename H>
+concept hasher = requires(H &h, const H &ch, std::string_view data) {
+  h.update(data);
+  ch.digest();
+};
+
+/// 64-bit FNV-1a
+class fnv1a_64 {
+public:
+  void update(std::string_view data) {
+    for (char c : data) {
+      this->state_ ^= static_cast<unsigned char>(c);
+      this->state_ *= 0x100000001b3ULL;
+    }
+  }
+
+  [[nodiscard]] std::uint64_t digest() const { return this->state_; }
+
+private:
+  std::uint64_t state_ = 0xcbf29ce484222325ULL;
+};
+
+/// CRC-32 (ISO-HDLC, as used by zlib)
+class crc32 {
+public:
+  void update(std::string_view data) {
+    for (char c : data) {
+      this->state_ = table[(this->state_ ^ static_cast<unsigned char>(c)) &
+                           0xFF] ^
+                     (this->state_ >> 8);
+    }
+  }
+
+  [[nodiscard]] std::uint32_t digest() const { return ~this->state_; }
+
+private:
+  static constexpr auto table = [] {
+    std::array<std::uint32_t, 256> t{};
+    for (std::uint32_t i = 0; i < t.size(); i++) {
+      std::uint32_t c = i;
+      for (int bit = 0; bit < 8; bit++) {
+        c = (c & 1) ? 0xEDB88320U ^ (c >> 1) : c >> 1;
+      }
+      t[i] = c;
+    }
+    return t;
+  }();
+
+  std::uint32_t state_ = 0xFFFFFFFFU;
+};
+
+/// Hashes every chunk before handing it to another sink.
+///
+/// Chunks are hashed right after they were written, while they're still in
+/// cache, so the output isn't read a second time.
+template <sink S, hasher H> class hashing_sink {
+public:
+  explicit hashing_sink(S &inner, H h = {})
+      : inner_(inner), hasher_(std::move(h)) {}
+
+  bool write(std::string_view chunk) {
+    this->hasher_.update(chunk);
+    return this->inner_.write(chunk);
+  }
+
+  [[nodiscard]] const H &hasher() const { return this->hasher_; }
+
+private:
+  S &inner_;
+  H hasher_;
+};
+
+/// Serialized output with the digest of its bytes
+template <typename D> struct hashed {
+  std::string text;
+  D digest;
+};
+
+/// Serializes `value` and hashes the output in the same pass.
+template <hasher H = fnv1a_64, typename T>
+auto serialize_hashed(const T &value,
+                      stream::format fmt = stream::format::compact)
+    -> std::optional<hashed<decltype(std::declval<const H &>().digest())>> {
+  std::string text;
+  auto append = callback_sink([&](std::string_view chunk) {
+    text.append(chunk);
+    return true;
+  });
+  hashing_sink<decltype(append), H> sink(append);
+  if (!serialize_to_sink(value, sink, 4096, fmt)) {
+    return std::nullopt;
+  }
+  return {{std::move(text), sink.hasher().digest()}};
+}
+
+} // namespace miniser
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <miniser/miniser.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace miniser {
+
+enum class decode_status {
+  /// The value isn't complete yet
+  need_more,
+  /// The value was decoded (`take()` returns it)
+  done,
+  /// The input is invalid or doesn't match the type
+  error,
+};
+
+namespace detail {
+
+inline bool is_json_ws(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool is_blank(std::string_view s) {
+  for (char c : s) {
+    if (!is_json_ws(c)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace detail
+
+/// Decodes a `T` from input that arrives in chunks (e.g. from the network).
+///
+/// Chunks are scanned as they arrive, so the end of the value is detected
+/// without another pass. If `T` is a `std::vector`, every element is decoded
+/// as soon as it's complete and its text is dropped, so only the element
+/// currently being received is buffered.
+template <typename T> class incremental_decoder {
+  static constexpr bool streaming = detail::is_vector<T>::value;
+
+public:
+  explicit incremental_decoder(deser::context ctx = {},
+                               yyjson_read_flag flags = 0)
+      : ctx_(ctx), flags_(flags) {}
+
+  /// Appends a chunk of the input.
+  decode_status feed(std::string_view chunk) {
+    if (this->status_ == decode_status::done) {
+      if (!detail::is_blank(chunk)) {
+        this->status_ = decode_status::error;
+      }
+      return this->status_;
+    }
+    if (this->status_ == decode_status::error) {
+      return this->status_;
+    }
+
+    this->buffer_.append(chunk);
+    this->scan();
+    return this->status_;
+  }
+
+  /// Signals the end of the input. This is only required to complete
+  /// top-level numbers and literals.
+  decode_status finish() {
+    if (this->status_ == decode_status::need_more) {
+      if (this->started_ && this->closers_.empty() && !this->in_string_) {
+        this->complete(this->buffer_.size());
+      } else {
+        this->status_ = decode_status::error;
+      }
+    }
+    return this->status_;
+  }
+
+  [[nodiscard]] decode_status status() const { return this->status_; }
+
+  /// Takes the decoded value (only valid once `done` was reported).
+  std::optional<T> take() { return std::move(this->value_); }
+
+private:
+  void scan() {
+    for (; this->pos_ < this->buffer_.size() &&
+           this->status_ == decode_status::need_more;
+         this->pos_++) {
+      char c = this->buffer_[this->pos_];
+      if (this->in_string_) {
+        if (this->escaped_) {
+          this->escaped_ = false;
+        } else if (c == '\\') {
+          this->escaped_ = true;
+        } else if (c == '"') {
+          this->in_string_ = false;
+          if (this->closers_.empty()) {
+            this->complete(this->pos_ + 1);
+          }
+        }
+        continue;
+      }
+
+      switch (c) {
+      case '"':
+        if (!this->begin_value(c)) {
+          return;
+        }
+        this->in_string_ = true;
+        break;
+      case '{':
+      case '[':
+        if (!this->begin_value(c)) {
+          return;
+        }
+        if constexpr (streaming) {
+          if (this->closers_.empty()) {
+            this->element_start_ = this->pos_ + 1;
+          }
+        }
+        this->closers_.push_back(c == '{' ? '}' : ']');
+        break;
+      case '}':
+      case ']':
+        // every closer must match the innermost opener
+        if (this->closers_.empty() || this->closers_.back() != c) {
+          this->status_ = decode_status::error;
+          return;
+        }
+        if constexpr (streaming) {
+          if (this->closers_.size() == 1 && !this->end_element(true)) {
+            return;
+          }
+        }
+        this->closers_.pop_back();
+        if (this->closers_.empty()) {
+          this->complete(this->pos_ + 1);
+        }
+        break;
+      case ',':
+        if (this->closers_.empty()) {
+          this->status_ = decode_status::error;
+          return;
+        }
+        if constexpr (streaming) {
+          if (this->closers_.size() == 1 && !this->end_element(false)) {
+            return;
+          }
+        }
+        break;
+      case ' ':
+      case '\t':
+      case '\n':
+      case '\r':
+        // whitespace terminates top-level numbers and literals
+        if (this->closers_.empty() && this->started_) {
+          this->complete(this->pos_);
+        }
+        break;
+      default:
+        // anything else continues a top-level number or literal
+        if (this->closers_.empty() && !this->started_ &&
+            !this->begin_value(c)) {
+          return;
+        }
+        break;
+      }
+    }
+
+    if constexpr (streaming) {
+      this->compact();
+    }
+  }
+
+  bool begin_value(char c) {
+    if (!this->closers_.empty()) {
+      return true;
+    }
+    // there must only be a single top-level value
+    if (this->started_ || (streaming && c != '[')) {
+      this->status_ = decode_status::error;
+      return false;
+    }
+    this->started_ = true;
+    return true;
+  }
+
+  /// Decodes the element that ends at the current position.
+  bool end_element(bool last) {
+    std::string_view text(this->buffer_.data() + this->element_start_,
+                          this->pos_ - this->element_start_);
+    if (detail::is_blank(text)) {
+      // only `[]` may be empty
+      if (!last || this->after_comma_) {
+        this->status_ = decode_status::error;
+        return false;
+      }
+      return true;
+    }
+    this->after_comma_ = !last;
+    this->element_start_ = this->pos_ + 1;
+
+    auto element = deserialize<typename T::value_type>(text, this->ctx_,
+                                                       this->flags_);
+    if (!element.has_value()) {
+      this->status_ = decode_status::error;
+      return false;
+    }
+    this->elements_.push_back(std::move(*element));
+    return true;
+  }
+
+  void complete(std::size_t end) {
+    if (!detail::is_blank(std::string_view(this->buffer_).substr(end))) {
+      this->status_ = decode_status::error;
+      return;
+    }
+    if constexpr (streaming) {
+      this->value_ = std::move(this->elements_);
+    } else {
+      this->value_ =
+          deserialize<T>(std::string_view(this->buffer_).substr(0, end),
+                         this->ctx_, this->flags_);
+    }
+    this->status_ =
+        this->value_.has_value() ? decode_status::done : decode_status::error;
+    this->buffer_.clear();
+  }
+
+  /// Drops the text of decoded elements.
+  void compact() {
+    if (this->status_ != decode_status::need_more ||
+        this->element_start_ == 0) {
+      return;
+    }
+    this->buffer_.erase(0, this->element_start_);
+    this->pos_ -= this->element_start_;
+    this->element_start_ = 0;
+  }
+
+  deser::context ctx_;
+  yyjson_read_flag flags_;
+  decode_status status_ = decode_status::need_more;
+
+  std::string buffer_;
+  std::size_t pos_ = 0;
+  /// The closing brackets of the open arrays and objects
+  std::string closers_;
+  bool started_ = false;
+  bool in_string_ = false;
+  bool escaped_ = false;
+
+  // only used when streaming
+  std::size_t element_start_ = 0;
+  bool after_comma_ = false;
+  std::conditional_t<streaming, T, std::nullptr_t> elements_{};
+
+  std::optional<T> value_;
+};
+
+} // namespace miniser
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <miniser/miniser.hpp>
+
+/// Instantiates `serialize`, `deserialize`, `deserialize_into` and
+/// `deserialize_borrowed` for a type once, instead of in every translation
+/// unit that uses them.
+///
+/// Put `MINISER_DECLARE_CODEC(Foo)` next to the definition of `Foo` (after
+/// any customization like `rename_fields`) and `MINISER_DEFINE_CODEC(Foo)` in
+/// a single source file. Other translation units then call the instantiations
+/// from that file (e.g. a library created with `miniser_add_codec_library`)
+/// instead of instantiating the whole template tree themselves.
+///
+/// Both macros must be used at global scope with the fully qualified type.
+
+#define MINISER_DETAIL_CODEC(prefix, ...)                                      \
+  prefix template std::optional<__VA_ARGS__> miniser::deserialize<             \
+      __VA_ARGS__>(std::string_view, const miniser::deser::context &,          \
+                   yyjson_read_flag);                                          \
+  prefix template bool miniser::deserialize_into<__VA_ARGS__>(                 \
+      std::string_view, __VA_ARGS__ &, const miniser::deser::context &,        \
+      yyjson_read_flag);                                                       \
+  prefix template std::optional<miniser::borrowed<__VA_ARGS__>>                \
+  miniser::deserialize_borrowed<__VA_ARGS__>(                                  \
+      std::string_view, const miniser::deser::context &, yyjson_read_flag);    \
+  prefix template std::optional<miniser::serialized>                           \
+  miniser::serialize<__VA_ARGS__>(const __VA_ARGS__ &, yyjson_write_flag)
+
+/// Declares that the codec of a type is instantiated in another file
+#define MINISER_DECLARE_CODEC(...) MINISER_DETAIL_CODEC(extern, __VA_ARGS__)
+
+/// Instantiates the codec of a type
+#define MINISER_DEFINE_CODEC(...) MINISER_DETAIL_CODEC(, __VA_ARGS__)
@@ -0,0 +1,343 @@
+#pragma once
+
+#include <miniser/detail/variant.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <string_view>
+#include <vector>
+#include <yyjson.h>
+
+#ifndef MINISER_ENABLE_METRICS
+#define MINISER_ENABLE_METRICS 0
+#endif
+
+namespace miniser::metrics {
+
+/// Metrics are only collected if `MINISER_ENABLE_METRICS` is set. Otherwise,
+/// all probes are empty and compile to nothing.
+inline constexpr bool enabled = MINISER_ENABLE_METRICS != 0;
+
+enum class operation { serialize, deserialize, deserialize_borrowed };
+
+/// A single call to `serialize`, `deserialize` or `deserialize_borrowed`
+struct event {
+  operation op;
+  /// Unqualified name of the (de-)serialized type
+  std::string_view type;
+  bool ok;
+  std::size_t bytes_in;
+  std::size_t bytes_out;
+  /// Time spent reading/writing JSON text
+  std::chrono::nanoseconds parse_time;
+  /// Time spent converting between the type and the yyjson document
+  std::chrono::nanoseconds convert_time;
+  /// Allocations made by yyjson
+  std::size_t allocations;
+};
+
+/// Aggregated metrics of one type
+struct counters {
+  std::uint64_t calls = 0;
+  std::uint64_t failures = 0;
+  std::uint64_t bytes_in = 0;
+  std::uint64_t bytes_out = 0;
+  std::uint64_t parse_ns = 0;
+  std::uint64_t convert_ns = 0;
+  std::uint64_t allocations = 0;
+
+  counters &operator+=(const counters &other) {
+    this->calls += other.calls;
+    this->failures += other.failures;
+    this->bytes_in += other.bytes_in;
+    this->bytes_out += other.bytes_out;
+    this->parse_ns += other.parse_ns;
+    this->convert_ns += other.convert_ns;
+    this->allocations += other.allocations;
+    return *this;
+  }
+};
+
+using sink_fn = void (*)(const event &);
+
+namespace detail {
+
+inline std::atomic<sink_fn> &sink() {
+  static std::atomic<sink_fn> fn = nullptr;
+  return fn;
+}
+
+/// Counters of one type written by a single thread.
+///
+/// Only the owning thread writes, so updates don't need read-modify-write
+/// atomics. Readers may observe slightly stale values.
+struct counter_block {
+  std::atomic<std::uint64_t> calls;
+  std::atomic<std::uint64_t> failures;
+  std::atomic<std::uint64_t> bytes_in;
+  std::atomic<std::uint64_t> bytes_out;
+  std::atomic<std::uint64_t> parse_ns;
+  std::atomic<std::uint64_t> convert_ns;
+  std::atomic<std::uint64_t> allocations;
+
+  static void bump(std::atomic<std::uint64_t> &counter, std::uint64_t by) {
+    counter.store(counter.load(std::memory_order_relaxed) + by,
+                  std::memory_order_relaxed);
+  }
+
+  void add(const event &ev) {
+    bump(this->calls, 1);
+    bump(this->failures, ev.ok ? 0 : 1);
+    bump(this->bytes_in, ev.bytes_in);
+    bump(this->bytes_out, ev.bytes_out);
+    bump(this->parse_ns, static_cast<std::uint64_t>(ev.parse_time.count()));
+    bump(this->convert_ns,
+         static_cast<std::uint64_t>(ev.convert_time.count()));
+    bump(this->allocations, ev.allocations);
+  }
+
+  [[nodiscard]] counters load() const {
+    return {
+        .calls = this->calls.load(std::memory_order_relaxed),
+        .failures = this->failures.load(std::memory_order_relaxed),
+        .bytes_in = this->bytes_in.load(std::memory_order_relaxed),
+        .bytes_out = this->bytes_out.load(std::memory_order_relaxed),
+        .parse_ns = this->parse_ns.load(std::memory_order_relaxed),
+        .convert_ns = this->convert_ns.load(std::memory_order_relaxed),
+        .allocations = this->allocations.load(std::memory_order_relaxed),
+    };
+  }
+};
+
+/// All counter blocks of one type
+struct type_registry {
+  std::string_view name;
+  std::mutex mutex;
+  std::vector<const counter_block *> live;
+  /// Counters of threads that exited
+  counters retired;
+
+  [[nodiscard]] counters aggregate() {
+    std::lock_guard lock(this->mutex);
+    counters total = this->retired;
+    for (const auto *block : this->live) {
+      total += block->load();
+    }
+    return total;
+  }
+};
+
+struct registry {
+  std::mutex mutex;
+  std::vector<type_registry *> types;
+
+  static registry &instance() {
+    static registry reg;
+    return reg;
+  }
+};
+
+// Registries are never destroyed, so threads exiting late can still retire
+// their counters.
+template <typename T> type_registry &registry_of() {
+  static type_registry *reg = [] {
+    auto *r = new type_registry;
+    r->name = miniser::detail::stored_type_name_v<T>.data();
+    auto &global = registry::instance();
+    std::lock_guard lock(global.mutex);
+    global.types.push_back(r);
+    return r;
+  }();
+  return *reg;
+}
+
+template <typename T> counter_block &local_block() {
+  thread_local struct holder {
+    counter_block block{};
+
+    holder() {
+      auto &reg = registry_of<T>();
+      std::lock_guard lock(reg.mutex);
+      reg.live.push_back(&this->block);
+    }
+    ~holder() {
+      auto &reg = registry_of<T>();
+      std::lock_guard lock(reg.mutex);
+      reg.retired += this->block.load();
+      std::erase(reg.live, &this->block);
+    }
+    holder(const holder &) = delete;
+    holder(holder &&) = delete;
+    holder &operator=(const holder &) = delete;
+    holder &operator=(holder &&) = delete;
+  } h;
+  return h.block;
+}
+
+/// Counts allocations and forwards them to `inner` (or malloc). Documents
+/// using it must be freed before it is destroyed.
+struct counting_state {
+  std::size_t *count;
+  const yyjson_alc *inner;
+};
+
+inline void *counting_malloc(void *ctx, size_t size) {
+  auto *state = static_cast<counting_state *>(ctx);
+  ++*state->count;
+  if (state->inner) {
+    return state->inner->malloc(state->inner->ctx, size);
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+  return malloc(size);
+}
+
+inline void *counting_realloc(void *ctx, void *ptr, size_t old_size,
+                              size_t size) {
+  auto *state = static_cast<counting_state *>(ctx);
+  ++*state->count;
+  if (state->inner) {
+    return state->inner->realloc(state->inner->ctx, ptr, old_size, size);
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+  return realloc(ptr, size);
+}
+
+inline void counting_free(void *ctx, void *ptr) {
+  auto *state = static_cast<counting_state *>(ctx);
+  if (state->inner) {
+    state->inner->free(state->inner->ctx, ptr);
+    return;
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+  free(ptr);
+}
+
+} // namespace detail
+
+/// Measures a single call. Disabled probes only pass on the allocator.
+template <typename T, bool = enabled> class probe {
+public:
+  probe(operation /*op*/, std::size_t /*bytes_in*/,
+        const yyjson_alc *alc = nullptr)
+      : alc_(alc) {}
+
+  /// Allocator to pass to yyjson for documents (`nullptr` uses the default
+  /// one)
+  [[nodiscard]] const yyjson_alc *allocator() const { return this->alc_; }
+
+  /// Allocator for output that is freed with `free()`
+  [[nodiscard]] const yyjson_alc *output_allocator() const { return nullptr; }
+
+  void parsed() {}
+  void converted() {}
+  void succeed(std::size_t /*bytes_out*/ = 0) {}
+
+private:
+  const yyjson_alc *alc_;
+};
+
+template <typename T> class probe<T, true> {
+  using clock = std::chrono::steady_clock;
+
+public:
+  probe(operation op, std::size_t bytes_in, const yyjson_alc *alc = nullptr)
+      : op_(op), bytes_in_(bytes_in), last_(clock::now()),
+        doc_state_{&this->allocations_, alc} {}
+  ~probe() {
+    event ev{
+        .op = this->op_,
+        .type = detail::registry_of<T>().name,
+        .ok = this->ok_,
+        .bytes_in = this->bytes_in_,
+        .bytes_out = this->bytes_out_,
+        .parse_time = this->parse_time_,
+        .convert_time = this->convert_time_,
+        .allocations = this->allocations_,
+    };
+    detail::local_block<T>().add(ev);
+    if (auto fn = detail::sink().load(std::memory_order_relaxed)) {
+      fn(ev);
+    }
+  }
+  probe(const probe &) = delete;
+  probe(probe &&) = delete;
+  probe &operator=(const probe &) = delete;
+  probe &operator=(probe &&) = delete;
+
+  [[nodiscard]] const yyjson_alc *allocator() const { return &this->alc_; }
+  [[nodiscard]] const yyjson_alc *output_allocator() const {
+    return &this->output_alc_;
+  }
+
+  /// Ends a phase of reading or writing text
+  void parsed() { this->parse_time_ += this->lap(); }
+  /// Ends a phase of converting between `T` and the document
+  void converted() { this->convert_time_ += this->lap(); }
+
+  void succeed(std::size_t bytes_out = 0) {
+    this->ok_ = true;
+    this->bytes_out_ = bytes_out;
+  }
+
+private:
+  std::chrono::nanoseconds lap() {
+    auto now = clock::now();
+    auto elapsed = now - this->last_;
+    this->last_ = now;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+  }
+
+  operation op_;
+  bool ok_ = false;
+  std::size_t bytes_in_;
+  std::size_t bytes_out_ = 0;
+  std::size_t allocations_ = 0;
+  clock::time_point last_;
+  std::chrono::nanoseconds parse_time_{};
+  std::chrono::nanoseconds convert_time_{};
+  detail::counting_state doc_state_;
+  detail::counting_state output_state_{&this->allocations_, nullptr};
+  yyjson_alc alc_{
+      .malloc = detail::counting_malloc,
+      .realloc = detail::counting_realloc,
+      .free = detail::counting_free,
+      .ctx = &this->doc_state_,
+  };
+  yyjson_alc output_alc_{
+      .malloc = detail::counting_malloc,
+      .realloc = detail::counting_realloc,
+      .free = detail::counting_free,
+      .ctx = &this->output_state_,
+  };
+};
+
+/// Calls `fn` for every event (`nullptr` to disable). `fn` is called on the
+/// thread that made the call.
+inline void set_sink(sink_fn fn) {
+  detail::sink().store(fn, std::memory_order_relaxed);
+}
+
+/// Metrics of `T` aggregated over all threads
+template <typename T> counters stats() {
+  return detail::registry_of<T>().aggregate();
+}
+
+/// Calls `fn(std::string_view name, const counters &)` for every type that was
+/// (de-)serialized so far.
+template <typename F> void for_each_type(F &&fn) {
+  auto &global = detail::registry::instance();
+  std::vector<detail::type_registry *> types;
+  {
+    std::lock_guard lock(global.mutex);
+    types = global.types;
+  }
+  for (auto *type : types) {
+    fn(type->name, type->aggregate());
+  }
+}
+
+} // namespace miniser::metrics
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <miniser/deser.hpp>
+#include <miniser/metrics.hpp>
 #include <miniser/ser.hpp>
+#include <miniser/thread_cache.hpp>
 
 #include <string_view>
 
@@ -62,33 +64,107 @@ private:
   T value_;
 };
 
+namespace detail {
+
+inline yydoc read(std::string_view str, yyjson_read_flag flags,
+                  const yyjson_alc *alc) {
+  // same as yyjson_read - the input is never modified without INSITU
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  return yyjson_read_opts(const_cast<char *>(str.data()), str.size(),
+                          flags & ~YYJSON_READ_INSITU, alc, nullptr);
+}
+
+/// `ctx` with the text of `doc` for raw values
+inline deser::context with_source(const deser::context &ctx,
+                                  source_text &source) {
+  deser::context out = ctx;
+  out.source = &source;
+  return out;
+}
+
+/// Reads `str` and converts the root with
+/// `convert(yyjson_val *, const deser::context &)`, passing `ctx` with the
+/// text of the document.
+template <typename T, typename F>
+std::optional<T> read_document(std::string_view str, yyjson_read_flag flags,
+                               const deser::context &ctx, F &&convert) {
+  metrics::probe<T> probe(metrics::operation::deserialize, str.size(),
+                          thread_cache::allocator());
+  yydoc doc = read(str, flags, probe.allocator());
+  probe.parsed();
+  if (!doc()) {
+    return std::nullopt;
+  }
+
+  source_text source(str, doc());
+  std::optional<T> de =
+      convert(yyjson_doc_get_root(doc()), with_source(ctx, source));
+  probe.converted();
+  if (de.has_value()) {
+    probe.succeed();
+  }
+  return de;
+}
+
+} // namespace detail
+
 template <typename T>
 std::optional<T> deserialize(std::string_view str,
                              const deser::context &ctx = {},
                              yyjson_read_flag flags = 0) {
-  detail::yydoc doc = yyjson_read(str.data(), str.size(), flags);
+  return detail::read_document<T>(
+      str, flags, ctx, [](yyjson_val *root, const deser::context &inner) {
+        return deser::deserialize(std::type_identity<T>{}, root, inner);
+      });
+}
+
+/// Deserializes `str` into `out`, reusing its storage (e.g. the capacity of
+/// strings and vectors). On failure, `out` is left in a valid but unspecified
+/// state.
+template <typename T>
+bool deserialize_into(std::string_view str, T &out,
+                      const deser::context &ctx = {},
+                      yyjson_read_flag flags = 0) {
+  metrics::probe<T> probe(metrics::operation::deserialize, str.size(),
+                          thread_cache::allocator());
+  detail::yydoc doc = detail::read(str, flags, probe.allocator());
+  probe.parsed();
   if (!doc()) {
-    return std::nullopt;
+    return false;
   }
 
-  return deser::deserialize(std::type_identity<T>{}, yyjson_doc_get_root(doc()),
-                            ctx);
+  detail::source_text source(str, doc());
+  bool ok = deser::deserialize_into(out, yyjson_doc_get_root(doc()),
+                                    detail::with_source(ctx, source));
+  probe.converted();
+  if (ok) {
+    probe.succeed();
+  }
+  return ok;
 }
 
 template <typename T>
 std::optional<borrowed<T>> deserialize_borrowed(std::string_view str,
                                                 const deser::context &ctx = {},
                                                 yyjson_read_flag flags = 0) {
-  detail::yydoc doc = yyjson_read(str.data(), str.size(), flags);
+  // The document outlives the probe, so its allocations can't be counted
+  metrics::probe<T> probe(metrics::operation::deserialize_borrowed,
+                          str.size());
+  detail::yydoc doc = detail::read(str, flags, thread_cache::allocator());
+  probe.parsed();
   if (!doc()) {
     return std::nullopt;
   }
 
+  detail::source_text source(str, doc());
   auto de = deser::deserialize(std::type_identity<T>{},
-                               yyjson_doc_get_root(doc()), ctx);
+                               yyjson_doc_get_root(doc()),
+                               detail::with_source(ctx, source));
+  probe.converted();
   if (!de.has_value()) {
     return std::nullopt;
   }
+  probe.succeed();
   return borrowed<T>(std::move(doc), std::forward<T>(*de));
 }
 
@@ -134,15 +210,20 @@ private:
   size_t len_ = 0;
 };
 
-template <typename T>
-std::optional<serialized> serialize(const T &value,
-                                    yyjson_write_flag flags = 0) {
-  detail::yydoc_mut doc = yyjson_mut_doc_new(nullptr);
+namespace detail {
+
+/// Writes a document with the root built by `build(yyjson_mut_doc *)`.
+template <typename T, typename F>
+std::optional<serialized> write_document(yyjson_write_flag flags, F &&build) {
+  metrics::probe<T> probe(metrics::operation::serialize, 0,
+                          thread_cache::allocator());
+  yydoc_mut doc = yyjson_mut_doc_new(probe.allocator());
   if (!doc()) {
     return std::nullopt;
   }
 
-  auto *root = ser::serialize(value, doc());
+  yyjson_mut_val *root = build(doc());
+  probe.converted();
   if (!root) {
     return std::nullopt;
   }
@@ -150,12 +231,26 @@ std::optional<serialized> serialize(const T &value,
   yyjson_mut_doc_set_root(doc(), root);
 
   size_t size = 0;
-  auto *str = yyjson_mut_write(doc(), flags, &size);
+  // The string is freed with free(), so only the default allocator (or one
+  // forwarding to malloc) may be used.
+  auto *str = yyjson_mut_write_opts(doc(), flags, probe.output_allocator(),
+                                    &size, nullptr);
+  probe.parsed();
   if (!str) {
     return std::nullopt;
   }
 
+  probe.succeed(size);
   return serialized(str, size);
 }
 
+} // namespace detail
+
+template <typename T>
+std::optional<serialized> serialize(const T &value,
+                                    yyjson_write_flag flags = 0) {
+  return detail::write_document<T>(
+      flags, [&](yyjson_mut_doc *doc) { return ser::serialize(value, doc); });
+}
+
 } // namespace miniser
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <miniser/miniser.hpp>
+
+#include <algorithm>
+#include <array>
+#include <boost/pfr.hpp>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// Plans are an alternative to the fully templated (de-)serialization of
+/// aggregates. Every aggregate gets a table of its fields (key, offset and
+/// codec), and objects are encoded and decoded by loops that aren't templates.
+/// Codecs are instantiated once per field type instead of once per field, so
+/// many types with similar fields produce less code and compile faster, at the
+/// cost of an indirect call per field.
+///
+/// Planned types must be default-constructible.
+namespace miniser::plan {
+
+struct field {
+  std::string_view key;
+  std::size_t offset;
+  yyjson_mut_val *(*encode)(const void *value, yyjson_mut_doc *doc);
+  bool (*decode)(void *out, yyjson_val *value, const deser::context &ctx);
+  /// Whether the value is left out (`nullptr` if it never is)
+  bool (*skip)(const void *value);
+  /// Value-initializes a missing field (`nullptr` if it must be present)
+  void (*fill_default)(void *out);
+};
+
+namespace detail {
+
+using miniser::detail::is_optional;
+using miniser::detail::is_vector;
+
+template <typename T> std::span<const field> fields_of();
+
+inline yyjson_mut_val *encode_object(const void *obj,
+                                     std::span<const field> fields,
+                                     yyjson_mut_doc *doc) {
+  auto *out = yyjson_mut_obj(doc);
+  if (!out) {
+    return out;
+  }
+
+  const auto *base = static_cast<const char *>(obj);
+  for (const auto &f : fields) {
+    if (f.skip && f.skip(base + f.offset)) {
+      continue;
+    }
+    auto *kv = yyjson_mut_strn(doc, f.key.data(), f.key.size());
+    if (!kv) {
+      continue;
+    }
+    auto *v = f.encode(base + f.offset, doc);
+    if (!v) {
+      continue;
+    }
+    yyjson_mut_obj_add(out, kv, v);
+  }
+  return out;
+}
+
+inline bool decode_object(void *obj, std::span<const field> fields,
+                          yyjson_val *value, const deser::context &ctx) {
+  if (!yyjson_is_obj(value)) {
+    return false;
+  }
+
+  auto *base = static_cast<char *>(obj);
+  deser::detail::ordered_members members(value);
+  for (std::size_t i = 0; i < fields.size(); i++) {
+    const auto &f = fields[i];
+    auto *inner = members.find(f.key, [&](std::string_view key) {
+      return std::any_of(fields.begin() + i + 1, fields.end(),
+                         [&](const field &later) { return later.key == key; });
+    });
+    if (!inner && f.fill_default) {
+      f.fill_default(base + f.offset);
+      continue;
+    }
+    if (!f.decode(base + f.offset, inner, ctx)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+yyjson_mut_val *encode_value(const void *value, yyjson_mut_doc *doc) {
+  const auto &v = *static_cast<const T *>(value);
+  if constexpr (miniser::detail::is_object_v<T>) {
+    return encode_object(value, fields_of<T>(), doc);
+  } else if constexpr (is_vector<T>::value) {
+    auto *arr = yyjson_mut_arr(doc);
+    if (!arr) {
+      return arr;
+    }
+    for (const auto &element : v) {
+      auto *s = encode_value<typename T::value_type>(&element, doc);
+      if (!s || !yyjson_mut_arr_append(arr, s)) {
+        return nullptr;
+      }
+    }
+    return arr;
+  } else if constexpr (is_optional<T>::value) {
+    if (!v.has_value()) {
+      return yyjson_mut_null(doc);
+    }
+    return encode_value<typename T::value_type>(&*v, doc);
+  } else {
+    return ser::serialize(v, doc);
+  }
+}
+
+template <typename T, typename F> bool skip_value(const void *value) {
+  return miniser::detail::skip_field<T>(*static_cast<const F *>(value));
+}
+
+template <typename F> void fill_default(void *out) {
+  *static_cast<F *>(out) = F{};
+}
+
+template <typename T>
+bool decode_value(void *out, yyjson_val *value, const deser::context &ctx) {
+  auto &o = *static_cast<T *>(out);
+  if constexpr (miniser::detail::is_object_v<T>) {
+    return decode_object(out, fields_of<T>(), value, ctx);
+  } else if constexpr (is_vector<T>::value) {
+    if (!yyjson_is_arr(value)) {
+      return false;
+    }
+    o.clear();
+    o.resize(yyjson_arr_size(value));
+
+    using E = typename T::value_type;
+    std::size_t i = 0;
+    yyjson_val *inner = nullptr;
+    yyjson_arr_iter iter = yyjson_arr_iter_with(value);
+    while ((inner = yyjson_arr_iter_next(&iter))) {
+      if constexpr (std::is_same_v<decltype(o[i]), E &>) {
+        if (!decode_value<E>(&o[i++], inner, ctx)) {
+          return false;
+        }
+      } else {
+        // the elements of e.g. std::vector<bool> can't be referenced
+        E element{};
+        if (!decode_value<E>(&element, inner, ctx)) {
+          return false;
+        }
+        o[i++] = std::move(element);
+      }
+    }
+    return true;
+  } else if constexpr (is_optional<T>::value) {
+    // same as deser: invalid values are treated as missing
+    if (yyjson_is_null(value)) {
+      o.reset();
+      return true;
+    }
+    o.emplace();
+    if (!decode_value<typename T::value_type>(&*o, value, ctx)) {
+      o.reset();
+    }
+    return true;
+  } else {
+    auto de = deser::deserialize(std::type_identity<T>{}, value, ctx);
+    if (!de.has_value()) {
+      return false;
+    }
+    o = std::move(*de);
+    return true;
+  }
+}
+
+inline std::size_t offset_of(const void *member, const char *base) {
+  return static_cast<std::size_t>(static_cast<const char *>(member) - base);
+}
+
+/// Builds the plan of `T`. Keys and codecs are known at compile time, the
+/// offsets are taken from a default-constructed `T` (which decoding in place
+/// needs anyway). All fields are set up by a single pack expansion, so there
+/// is no code per field of each `T` besides its codecs.
+template <typename T, std::size_t... I>
+auto build_plan(std::index_sequence<I...> /*indices*/) {
+  static const T sample{};
+  const auto *base = reinterpret_cast<const char *>(std::addressof(sample));
+  const auto members = boost::pfr::structure_tie(sample);
+
+  return std::array<field, sizeof...(I)>{field{
+      .key = miniser::detail::field_names<T>[I],
+      .offset = offset_of(std::addressof(std::get<I>(members)), base),
+      .encode = &encode_value<deser::detail::field_type<T, I>>,
+      .decode = &decode_value<deser::detail::field_type<T, I>>,
+      .skip = skip_fields<T> == skip::none
+                  ? nullptr
+                  : &skip_value<T, deser::detail::field_type<T, I>>,
+      .fill_default = default_missing_fields<T>
+                          ? &fill_default<deser::detail::field_type<T, I>>
+                          : nullptr,
+  }...};
+}
+
+template <typename T> std::span<const field> fields_of() {
+  static const auto fields =
+      build_plan<T>(std::make_index_sequence<boost::pfr::tuple_size_v<T>>{});
+  return fields;
+}
+
+} // namespace detail
+
+} // namespace miniser::plan
+
+namespace miniser {
+
+/// Like `serialize`, but aggregates are serialized through their plans.
+template <typename T>
+std::optional<serialized> serialize_planned(const T &value,
+                                            yyjson_write_flag flags = 0) {
+  return detail::write_document<T>(flags, [&](yyjson_mut_doc *doc) {
+    return plan::detail::encode_value<T>(&value, doc);
+  });
+}
+
+/// Like `deserialize`, but aggregates are deserialized through their plans.
+template <typename T>
+std::optional<T> deserialize_planned(std::string_view str,
+                                     const deser::context &ctx = {},
+                                     yyjson_read_flag flags = 0) {
+  return detail::read_document<T>(
+      str, flags, ctx, [](yyjson_val *root, const deser::context &inner) {
+        std::optional<T> out(std::in_place);
+        if (!plan::detail::decode_value<T>(&*out, root, inner)) {
+          out.reset();
+        }
+        return out;
+      });
+}
+
+} // namespace miniser
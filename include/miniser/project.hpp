@@ -0,0 +1,157 @@
+#pragma once
+
+#include <miniser/detail/scanner.hpp>
+#include <miniser/miniser.hpp>
+
+#include <array>
+#include <boost/pfr.hpp>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace miniser {
+
+namespace detail {
+
+template <typename T>
+using field_mask = std::array<bool, boost::pfr::tuple_size_v<T>>;
+
+/// Copies the members of the object in `str` that are selected fields of `T`
+/// into a new object in `out`. Other members are only scanned.
+template <typename T>
+bool collect_fields(std::string_view str, const field_mask<T> &selected,
+                    std::string &out) {
+  constexpr auto n_fields = boost::pfr::tuple_size_v<T>;
+
+  std::array<std::string_view, n_fields> values{};
+  scanner sc(str);
+  if (!sc.consume('{')) {
+    return false;
+  }
+  if (!sc.consume('}')) {
+    do {
+      std::string_view key;
+      if (!sc.count_element() || !sc.scan_string(key) || !sc.consume(':')) {
+        return false;
+      }
+
+      std::size_t index = 0;
+      if (key.find('\\') == std::string_view::npos) {
+        index = field_index<T>(key);
+      } else {
+        index = field_index<T>(unescape(key));
+      }
+
+      sc.peek(); // skips whitespace
+      auto start = sc.position();
+      if (!sc.skip_value(1)) {
+        return false;
+      }
+      // like yyjson_obj_get, the first occurrence of a key is used
+      if (index < n_fields && selected[index] && !values[index].data()) {
+        values[index] = str.substr(start, sc.position() - start);
+      }
+    } while (sc.consume(','));
+
+    if (!sc.consume('}')) {
+      return false;
+    }
+  }
+  if (!sc.at_end()) {
+    return false;
+  }
+
+  out.clear();
+  out.push_back('{');
+  for (std::size_t i = 0; i < n_fields; i++) {
+    if (!values[i].data()) {
+      continue;
+    }
+    if (out.size() > 1) {
+      out.push_back(',');
+    }
+    out.push_back('"');
+    out.append(field_names<T>[i]);
+    out.append("\":");
+    out.append(values[i]);
+  }
+  out.push_back('}');
+  return true;
+}
+
+template <typename T, typename... M>
+field_mask<T> select_fields(const T &sample, M T::*...members) {
+  field_mask<T> selected{};
+  boost::pfr::for_each_field(sample, [&](const auto &field, auto index) {
+    selected[index] = ((static_cast<const void *>(&(sample.*members)) ==
+                        static_cast<const void *>(&field)) ||
+                       ...);
+  });
+  return selected;
+}
+
+} // namespace detail
+
+/// Deserializes `T` from an object that may have many more members than `T`
+/// has fields (e.g. a slim view of a large message).
+///
+/// Members that aren't fields of `T` are skipped by a scanner without being
+/// parsed, so only the values of the fields of `T` are parsed and converted.
+/// Only standard JSON nested at most `limits{}.max_depth` levels is accepted.
+template <typename T>
+  requires detail::is_object_v<T>
+std::optional<T> deserialize_projected(std::string_view str,
+                                       const deser::context &ctx = {},
+                                       yyjson_read_flag flags = 0) {
+  detail::field_mask<T> all;
+  all.fill(true);
+
+  std::string slim;
+  if (!detail::collect_fields<T>(str, all, slim)) {
+    return std::nullopt;
+  }
+  return deserialize<T>(slim, ctx, flags);
+}
+
+/// Deserializes only the fields `Members` of `T`, like
+/// `deserialize_fields<Event, &Event::id, &Event::ts>(str)`. All other fields
+/// are value-initialized and their values are skipped like in
+/// `deserialize_projected`.
+template <typename T, auto... Members>
+  requires detail::is_object_v<T> && std::is_default_constructible_v<T> &&
+           (std::is_member_object_pointer_v<decltype(Members)> && ...)
+std::optional<T> deserialize_fields(std::string_view str,
+                                    const deser::context &ctx = {},
+                                    yyjson_read_flag flags = 0) {
+  std::optional<T> out(std::in_place);
+  auto selected = detail::select_fields(*out, Members...);
+
+  std::string slim;
+  if (!detail::collect_fields<T>(str, selected, slim)) {
+    return std::nullopt;
+  }
+
+  auto convert = [&](yyjson_val *root, const deser::context &inner) {
+    bool ok = true;
+    boost::pfr::for_each_field(*out, [&](auto &field, auto index) {
+      if (!ok || !selected[index]) {
+        return;
+      }
+      auto key = detail::name_of_field<index, T>;
+      auto *member = yyjson_obj_getn(root, key.data(), key.size());
+      if (!member && default_missing_fields<T>) {
+        return;
+      }
+      ok = deser::deserialize_into(field, member, inner);
+    });
+    if (!ok) {
+      out.reset();
+    }
+    return std::move(out);
+  };
+  return detail::read_document<T>(slim, flags, ctx, convert);
+}
+
+} // namespace miniser
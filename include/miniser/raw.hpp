@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <yyjson.h>
+
+namespace miniser {
+
+/// A JSON number kept as its literal text.
+///
+/// Numbers are only kept verbatim if they're read as raw
+/// (`YYJSON_READ_NUMBER_AS_RAW` or `YYJSON_READ_BIGNUM_AS_RAW`). Other numbers
+/// are re-encoded by yyjson. On serialization, the text is written unchanged.
+/// Integer and real fields parse raw numbers, so they can be read with the
+/// same flags.
+class raw_number {
+public:
+  raw_number() = default;
+  explicit raw_number(std::string text) : text_(std::move(text)) {}
+
+  [[nodiscard]] std::string_view view() const { return this->text_; }
+  [[nodiscard]] const std::string &str() const { return this->text_; }
+
+  bool operator==(const raw_number &other) const = default;
+
+private:
+  std::string text_;
+};
+
+/// An opaque JSON value (e.g. a sub-document) that's forwarded without being
+/// converted.
+///
+/// The value is stored as its text in the input (or as minified JSON if it's
+/// deserialized from a `yyjson_val` without the text, or if the text can't be
+/// scanned). On serialization, the text is spliced into the output unchanged.
+class raw_json {
+public:
+  raw_json() = default;
+  explicit raw_json(std::string text) : text_(std::move(text)) {}
+
+  [[nodiscard]] std::string_view view() const { return this->text_; }
+  [[nodiscard]] const std::string &str() const { return this->text_; }
+
+  bool operator==(const raw_json &other) const = default;
+
+private:
+  std::string text_;
+};
+
+/// Like `raw_json`, but references the value in the parsed document and its
+/// text in the input.
+///
+/// Warning: this must be used with deserialize_borrowed, and the input must
+/// outlive it!
+class raw_json_view {
+public:
+  raw_json_view() = default;
+  explicit raw_json_view(yyjson_val *value, std::string_view text = {})
+      : value_(value), text_(text) {}
+
+  [[nodiscard]] yyjson_val *value() const { return this->value_; }
+  /// The text of the value in the input (empty if it's unknown, in which case
+  /// the value is re-encoded on serialization)
+  [[nodiscard]] std::string_view text() const { return this->text_; }
+
+private:
+  yyjson_val *value_ = nullptr;
+  std::string_view text_;
+};
+
+} // namespace miniser
@@ -1,10 +1,18 @@
 #pragma once
 
+#include <array>
 #include <boost/pfr.hpp>
+#include <miniser/bytes.hpp>
+#include <miniser/codec.hpp>
 #include <miniser/detail/names.hpp>
+#include <miniser/detail/skip.hpp>
+#include <miniser/detail/variant.hpp>
+#include <miniser/raw.hpp>
 #include <optional>
+#include <string>
 #include <string_view>
 #include <type_traits>
+#include <variant>
 #include <vector>
 #include <yyjson.h>
 
@@ -14,10 +22,20 @@ inline yyjson_mut_val *serialize(bool value, yyjson_mut_doc *doc) {
   return yyjson_mut_bool(doc, value);
 }
 
+/// Written with the shortest representation that round-trips as a float
+inline yyjson_mut_val *serialize(float value, yyjson_mut_doc *doc) {
+  return yyjson_mut_float(doc, value);
+}
+
 inline yyjson_mut_val *serialize(double value, yyjson_mut_doc *doc) {
   return yyjson_mut_real(doc, value);
 }
 
+/// Written with double precision
+inline yyjson_mut_val *serialize(long double value, yyjson_mut_doc *doc) {
+  return yyjson_mut_real(doc, static_cast<double>(value));
+}
+
 inline yyjson_mut_val *serialize(uint8_t value, yyjson_mut_doc *doc) {
   return yyjson_mut_uint(doc, static_cast<uint64_t>(value));
 }
@@ -59,8 +77,41 @@ inline yyjson_mut_val *serialize(std::string_view value, yyjson_mut_doc *doc) {
   return yyjson_mut_strn(doc, value.data(), value.size());
 }
 
+inline yyjson_mut_val *serialize(const raw_number &value,
+                                 yyjson_mut_doc *doc) {
+  if (value.view().empty()) {
+    return nullptr;
+  }
+  return yyjson_mut_rawn(doc, value.view().data(), value.view().size());
+}
+
+inline yyjson_mut_val *serialize(const raw_json &value, yyjson_mut_doc *doc) {
+  if (value.view().empty()) {
+    return nullptr;
+  }
+  return yyjson_mut_rawn(doc, value.view().data(), value.view().size());
+}
+
+inline yyjson_mut_val *serialize(const raw_json_view &value,
+                                 yyjson_mut_doc *doc) {
+  if (!value.text().empty()) {
+    return yyjson_mut_rawncpy(doc, value.text().data(), value.text().size());
+  }
+  if (!value.value()) {
+    return nullptr;
+  }
+  return yyjson_val_mut_copy(doc, value.value());
+}
+
+template <bytes_encoding E>
+yyjson_mut_val *serialize(const basic_bytes<E> &value, yyjson_mut_doc *doc);
+
+template <typename T>
+  requires miniser::detail::is_object_v<T>
+yyjson_mut_val *serialize(const T &value, yyjson_mut_doc *doc);
+
 template <typename T>
-  requires std::is_aggregate_v<T>
+  requires has_codec<T>
 yyjson_mut_val *serialize(const T &value, yyjson_mut_doc *doc);
 
 template <typename T>
@@ -69,10 +120,29 @@ yyjson_mut_val *serialize(const std::vector<T> &vec, yyjson_mut_doc *doc);
 template <typename T>
 yyjson_mut_val *serialize(const std::optional<T> &opt, yyjson_mut_doc *doc);
 
+template <typename... Ts>
+yyjson_mut_val *serialize(const std::variant<Ts...> &var, yyjson_mut_doc *doc);
+
 // Implementations
 
+template <bytes_encoding E>
+yyjson_mut_val *serialize(const basic_bytes<E> &value, yyjson_mut_doc *doc) {
+  // yyjson copies strings into the document, so short texts are encoded on
+  // the stack and only longer ones need a temporary buffer
+  constexpr std::size_t stack_size = 1024;
+  auto size = miniser::detail::encoded_size<E>(value.size());
+  if (size <= stack_size) {
+    std::array<char, stack_size> buf;
+    miniser::detail::encode_bytes<E>(value.view(), buf.data());
+    return yyjson_mut_strncpy(doc, buf.data(), size);
+  }
+  std::string text(size, '\0');
+  miniser::detail::encode_bytes<E>(value.view(), text.data());
+  return yyjson_mut_strncpy(doc, text.data(), size);
+}
+
 template <typename T>
-  requires std::is_aggregate_v<T>
+  requires miniser::detail::is_object_v<T>
 yyjson_mut_val *serialize(const T &value, yyjson_mut_doc *doc) {
   auto *obj = yyjson_mut_obj(doc);
   if (!obj) {
@@ -80,6 +150,9 @@ yyjson_mut_val *serialize(const T &value, yyjson_mut_doc *doc) {
   }
 
   boost::pfr::for_each_field(value, [&](const auto &field, auto index) {
+    if (miniser::detail::skip_field<T>(field)) {
+      return;
+    }
     auto key = miniser::detail::name_of_field<index, T>;
     auto *kv = yyjson_mut_strn(doc, key.data(), key.size());
     if (!kv) {
@@ -94,6 +167,21 @@ yyjson_mut_val *serialize(const T &value, yyjson_mut_doc *doc) {
   return obj;
 }
 
+template <typename T>
+  requires has_codec<T>
+yyjson_mut_val *serialize(const T &value, yyjson_mut_doc *doc) {
+  if constexpr (string_codec<T>) {
+    // yyjson's API can only copy strings into a document, so the (short) text
+    // is encoded on the stack; `serialize_to_sink` writes it to the output
+    std::array<char, codec<T>::max_size> buf;
+    auto n = codec<T>::encode(value, buf.data());
+    return yyjson_mut_strncpy(doc, buf.data(), n);
+  } else {
+    const typename codec<T>::repr repr = codec<T>::encode(value);
+    return serialize(repr, doc);
+  }
+}
+
 template <typename T>
 yyjson_mut_val *serialize(const std::vector<T> &vec, yyjson_mut_doc *doc) {
   auto *arr = yyjson_mut_arr(doc);
@@ -123,4 +211,59 @@ yyjson_mut_val *serialize(const std::optional<T> &opt, yyjson_mut_doc *doc) {
   return serialize(*opt, doc);
 }
 
+template <typename... Ts>
+yyjson_mut_val *serialize(const std::variant<Ts...> &var, yyjson_mut_doc *doc) {
+  using V = std::variant<Ts...>;
+
+  if (var.valueless_by_exception()) {
+    return nullptr;
+  }
+
+  auto *inner = std::visit(
+      [&](const auto &alternative) { return serialize(alternative, doc); },
+      var);
+  if (!inner) {
+    return nullptr;
+  }
+
+  auto tag = miniser::detail::variant_tags<V>::names[var.index()];
+  auto *tv = yyjson_mut_strn(doc, tag.data(), tag.size());
+  if (!tv) {
+    return nullptr;
+  }
+
+  if constexpr (tag_variant<V> == tagging::internal) {
+    if (!yyjson_mut_is_obj(inner)) {
+      return nullptr;
+    }
+    auto key = variant_tag_field<V>;
+    auto *kv = yyjson_mut_strn(doc, key.data(), key.size());
+    if (!kv || !yyjson_mut_obj_insert(inner, kv, tv, 0)) {
+      return nullptr;
+    }
+    return inner;
+  } else {
+    auto *obj = yyjson_mut_obj(doc);
+    if (!obj) {
+      return nullptr;
+    }
+
+    if constexpr (tag_variant<V> == tagging::external) {
+      if (!yyjson_mut_obj_add(obj, tv, inner)) {
+        return nullptr;
+      }
+    } else {
+      auto tag_key = variant_tag_field<V>;
+      auto content_key = variant_content_field<V>;
+      auto *tk = yyjson_mut_strn(doc, tag_key.data(), tag_key.size());
+      auto *ck = yyjson_mut_strn(doc, content_key.data(), content_key.size());
+      if (!tk || !ck || !yyjson_mut_obj_add(obj, tk, tv) ||
+          !yyjson_mut_obj_add(obj, ck, inner)) {
+        return nullptr;
+      }
+    }
+    return obj;
+  }
+}
+
 } // namespace miniser::ser
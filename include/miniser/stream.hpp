@@ -0,0 +1,692 @@
+#pragma once
+
+#include <miniser/bytes.hpp>
+#include <miniser/codec.hpp>
+#include <miniser/detail/names.hpp>
+#include <miniser/detail/skip.hpp>
+#include <miniser/detail/variant.hpp>
+#include <miniser/raw.hpp>
+
+#include <algorithm>
+#include <array>
+#include <boost/pfr.hpp>
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <yyjson.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+namespace miniser {
+
+/// Receives serialized output in chunks.
+///
+/// `write` may block to apply backpressure. Returning `false` aborts the
+/// serialization.
+template <typename S>
+concept sink = requires(S &s, std::string_view chunk) {
+  { s.write(chunk) } -> std::convertible_to<bool>;
+};
+
+/// Writes to a `std::ostream`
+class ostream_sink {
+public:
+  explicit ostream_sink(std::ostream &os) : os_(os) {}
+
+  bool write(std::string_view chunk) {
+    this->os_.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    return this->os_.good();
+  }
+
+private:
+  std::ostream &os_;
+};
+
+/// Writes to a file descriptor (blocking until everything is written)
+class fd_sink {
+public:
+  explicit fd_sink(int fd) : fd_(fd) {}
+
+  bool write(std::string_view chunk) {
+    while (!chunk.empty()) {
+#ifdef _WIN32
+      auto n = ::_write(this->fd_, chunk.data(),
+                        static_cast<unsigned int>(chunk.size()));
+#else
+      auto n = ::write(this->fd_, chunk.data(), chunk.size());
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+#endif
+      if (n <= 0) {
+        return false;
+      }
+      chunk.remove_prefix(static_cast<std::size_t>(n));
+    }
+    return true;
+  }
+
+private:
+  int fd_;
+};
+
+/// Calls `fn(std::string_view) -> bool` for every chunk
+template <typename F> class callback_sink {
+public:
+  explicit callback_sink(F fn) : fn_(std::move(fn)) {}
+
+  bool write(std::string_view chunk) { return this->fn_(chunk); }
+
+private:
+  F fn_;
+};
+
+namespace stream {
+
+enum class format {
+  /// Fields in declaration order
+  compact,
+  /// Fields sorted by their names and `-0.0` written as `0.0`, so equal values
+  /// produce identical output. Raw values are written unchanged.
+  canonical,
+};
+
+/// Buffers output and hands it to a sink in chunks of a fixed size.
+///
+/// Errors are sticky: once the sink failed (or a value couldn't be written),
+/// all further writes are ignored.
+class writer {
+public:
+  template <sink S>
+  writer(S &s, char *buffer, std::size_t capacity,
+         format fmt = format::compact)
+      : sink_(&s),
+        write_fn_([](void *sink, std::string_view chunk) {
+          return static_cast<bool>(static_cast<S *>(sink)->write(chunk));
+        }),
+        buffer_(buffer), capacity_(capacity), format_(fmt) {}
+
+  void put(char c) {
+    if (this->len_ == this->capacity_ && !this->flush()) {
+      return;
+    }
+    this->buffer_[this->len_++] = c;
+  }
+
+  void put(std::string_view s) {
+    while (!s.empty() && this->ok_) {
+      if (this->len_ == this->capacity_ && !this->flush()) {
+        return;
+      }
+      auto n = std::min(s.size(), this->capacity_ - this->len_);
+      std::char_traits<char>::copy(this->buffer_ + this->len_, s.data(), n);
+      this->len_ += n;
+      s.remove_prefix(n);
+    }
+  }
+
+  /// Returns space for `n` bytes at the end of the buffer (flushing it first
+  /// if needed), or `nullptr` if the buffer is smaller or the output failed.
+  /// Bytes written there are only added by `commit`.
+  char *reserve(std::size_t n) {
+    if (this->capacity_ - this->len_ < n && !this->flush()) {
+      return nullptr;
+    }
+    if (!this->ok_ || this->capacity_ - this->len_ < n) {
+      return nullptr;
+    }
+    return this->buffer_ + this->len_;
+  }
+
+  /// Adds `n` bytes written to the space returned by `reserve`.
+  void commit(std::size_t n) { this->len_ += n; }
+
+  /// Hands the buffered output to the sink.
+  bool flush() {
+    if (this->ok_ && this->len_ > 0) {
+      this->ok_ = this->write_fn_(this->sink_, {this->buffer_, this->len_});
+      this->len_ = 0;
+    }
+    return this->ok_;
+  }
+
+  /// Marks the output as failed.
+  void fail() { this->ok_ = false; }
+
+  [[nodiscard]] bool ok() const { return this->ok_; }
+
+  [[nodiscard]] bool canonical() const {
+    return this->format_ == format::canonical;
+  }
+
+private:
+  void *sink_;
+  bool (*write_fn_)(void *, std::string_view);
+  char *buffer_;
+  std::size_t capacity_;
+  std::size_t len_ = 0;
+  bool ok_ = true;
+  format format_;
+};
+
+namespace detail {
+
+void write_string(std::string_view value, writer &w);
+
+bool needs_escape(std::string_view value);
+
+template <typename T> void write_integer(T value, writer &w);
+
+template <typename T> void write_real(T value, writer &w);
+
+/// A member written among the fields of an aggregate
+struct extra_member {
+  std::string_view key;
+  std::string_view value;
+};
+
+template <typename T>
+void write_members(const T &value, writer &w, const extra_member *extra);
+
+} // namespace detail
+
+// Declarations
+
+void write(bool value, writer &w);
+
+void write(float value, writer &w);
+void write(double value, writer &w);
+void write(long double value, writer &w);
+
+void write(std::uint8_t value, writer &w);
+void write(std::uint16_t value, writer &w);
+void write(std::uint32_t value, writer &w);
+void write(std::uint64_t value, writer &w);
+void write(std::int8_t value, writer &w);
+void write(std::int16_t value, writer &w);
+void write(std::int32_t value, writer &w);
+void write(std::int64_t value, writer &w);
+
+void write(const std::string &value, writer &w);
+void write(std::string_view value, writer &w);
+
+void write(const raw_number &value, writer &w);
+void write(const raw_json &value, writer &w);
+void write(const raw_json_view &value, writer &w);
+
+template <bytes_encoding E> void write(const basic_bytes<E> &value, writer &w);
+
+template <typename T>
+  requires miniser::detail::is_object_v<T>
+void write(const T &value, writer &w);
+
+template <typename T>
+  requires has_codec<T>
+void write(const T &value, writer &w);
+
+template <typename T> void write(const std::vector<T> &vec, writer &w);
+
+template <typename T> void write(const std::optional<T> &opt, writer &w);
+
+template <typename... Ts>
+void write(const std::variant<Ts...> &var, writer &w);
+
+// Implementations
+
+inline void write(bool value, writer &w) { w.put(value ? "true" : "false"); }
+
+inline void write(float value, writer &w) { detail::write_real(value, w); }
+inline void write(double value, writer &w) { detail::write_real(value, w); }
+inline void write(long double value, writer &w) {
+  detail::write_real(static_cast<double>(value), w);
+}
+
+inline void write(std::uint8_t value, writer &w) {
+  detail::write_integer(value, w);
+}
+inline void write(std::uint16_t value, writer &w) {
+  detail::write_integer(value, w);
+}
+inline void write(std::uint32_t value, writer &w) {
+  detail::write_integer(value, w);
+}
+inline void write(std::uint64_t value, writer &w) {
+  detail::write_integer(value, w);
+}
+inline void write(std::int8_t value, writer &w) {
+  detail::write_integer(value, w);
+}
+inline void write(std::int16_t value, writer &w) {
+  detail::write_integer(value, w);
+}
+inline void write(std::int32_t value, writer &w) {
+  detail::write_integer(value, w);
+}
+inline void write(std::int64_t value, writer &w) {
+  detail::write_integer(value, w);
+}
+
+inline void write(const std::string &value, writer &w) {
+  detail::write_string(value, w);
+}
+inline void write(std::string_view value, writer &w) {
+  detail::write_string(value, w);
+}
+
+inline void write(const raw_number &value, writer &w) {
+  if (value.view().empty()) {
+    w.fail();
+    return;
+  }
+  w.put(value.view());
+}
+
+inline void write(const raw_json &value, writer &w) {
+  if (value.view().empty()) {
+    w.fail();
+    return;
+  }
+  w.put(value.view());
+}
+
+inline void write(const raw_json_view &value, writer &w) {
+  if (!value.text().empty()) {
+    w.put(value.text());
+    return;
+  }
+  size_t size = 0;
+  char *s = value.value() ? yyjson_val_write(value.value(), 0, &size) : nullptr;
+  if (!s) {
+    w.fail();
+    return;
+  }
+  w.put(std::string_view(s, size));
+  // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+  free(s);
+}
+
+template <typename T>
+  requires miniser::detail::is_object_v<T>
+void write(const T &value, writer &w) {
+  w.put('{');
+  detail::write_members(value, w, nullptr);
+  w.put('}');
+}
+
+/// Encoded in blocks straight into the output (the encoding never needs to be
+/// escaped).
+template <bytes_encoding E> void write(const basic_bytes<E> &value, writer &w) {
+  // a multiple of 3 bytes, so only the last block may be padded
+  constexpr std::size_t block = 768;
+  constexpr std::size_t max_encoded = miniser::detail::encoded_size<E>(block);
+
+  w.put('"');
+  auto data = value.view();
+  while (!data.empty() && w.ok()) {
+    auto in = data.first(std::min(block, data.size()));
+    data = data.subspan(in.size());
+    auto n = miniser::detail::encoded_size<E>(in.size());
+    if (char *out = w.reserve(n)) {
+      miniser::detail::encode_bytes<E>(in, out);
+      w.commit(n);
+    } else {
+      std::array<char, max_encoded> buf;
+      miniser::detail::encode_bytes<E>(in, buf.data());
+      w.put(std::string_view(buf.data(), n));
+    }
+  }
+  w.put('"');
+}
+
+template <typename T>
+  requires has_codec<T>
+void write(const T &value, writer &w) {
+  if constexpr (string_codec<T>) {
+    constexpr std::size_t size = codec<T>::max_size;
+    // encode straight into the output, which only has to be redone if the
+    // encoded string must be escaped
+    if (char *out = w.reserve(size + 2)) {
+      auto n = codec<T>::encode(value, out + 1);
+      if (!detail::needs_escape({out + 1, n})) {
+        out[0] = '"';
+        out[n + 1] = '"';
+        w.commit(n + 2);
+        return;
+      }
+    }
+
+    std::array<char, size> buf;
+    auto n = codec<T>::encode(value, buf.data());
+    detail::write_string({buf.data(), n}, w);
+  } else {
+    const typename codec<T>::repr repr = codec<T>::encode(value);
+    write(repr, w);
+  }
+}
+
+template <typename T> void write(const std::vector<T> &vec, writer &w) {
+  w.put('[');
+  bool first = true;
+  for (const auto &value : vec) {
+    if (!first) {
+      w.put(',');
+    }
+    first = false;
+    write(value, w);
+    if (!w.ok()) {
+      return;
+    }
+  }
+  w.put(']');
+}
+
+template <typename T> void write(const std::optional<T> &opt, writer &w) {
+  if (!opt.has_value()) {
+    w.put("null");
+    return;
+  }
+  write(*opt, w);
+}
+
+template <typename... Ts>
+void write(const std::variant<Ts...> &var, writer &w) {
+  using V = std::variant<Ts...>;
+
+  if (var.valueless_by_exception()) {
+    w.fail();
+    return;
+  }
+
+  auto tag = miniser::detail::variant_tags<V>::names[var.index()];
+  auto put_key = [&](std::string_view key) {
+    detail::write_string(key, w);
+    w.put(':');
+  };
+
+  if constexpr (tag_variant<V> == tagging::internal) {
+    // the tag is a member of the alternative
+    std::visit(
+        [&](const auto &alternative) {
+          if constexpr (miniser::detail::is_object_v<
+                            std::remove_cvref_t<decltype(alternative)>>) {
+            detail::extra_member member{variant_tag_field<V>, tag};
+            w.put('{');
+            detail::write_members(alternative, w, &member);
+            w.put('}');
+          } else {
+            w.fail();
+          }
+        },
+        var);
+  } else if constexpr (tag_variant<V> == tagging::external) {
+    w.put('{');
+    put_key(tag);
+    std::visit([&](const auto &alternative) { write(alternative, w); }, var);
+    w.put('}');
+  } else {
+    auto put_tag = [&] {
+      put_key(variant_tag_field<V>);
+      detail::write_string(tag, w);
+    };
+    auto put_content = [&] {
+      put_key(variant_content_field<V>);
+      std::visit([&](const auto &alternative) { write(alternative, w); }, var);
+    };
+
+    w.put('{');
+    if (w.canonical() && variant_content_field<V> < variant_tag_field<V>) {
+      put_content();
+      w.put(',');
+      put_tag();
+    } else {
+      put_tag();
+      w.put(',');
+      put_content();
+    }
+    w.put('}');
+  }
+}
+
+namespace detail {
+
+inline bool needs_escape(std::string_view value) {
+  return std::any_of(value.begin(), value.end(), [](char ch) {
+    auto c = static_cast<unsigned char>(ch);
+    return c < 0x20 || c == '"' || c == '\\';
+  });
+}
+
+inline void write_string(std::string_view value, writer &w) {
+  static constexpr std::string_view hex = "0123456789abcdef";
+
+  w.put('"');
+  std::size_t run = 0;
+  for (std::size_t i = 0; i < value.size(); i++) {
+    auto c = static_cast<unsigned char>(value[i]);
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+
+    // flush the run of characters that don't need escaping
+    w.put(value.substr(run, i - run));
+    run = i + 1;
+    switch (c) {
+    case '"':
+      w.put("\\\"");
+      break;
+    case '\\':
+      w.put("\\\\");
+      break;
+    case '\b':
+      w.put("\\b");
+      break;
+    case '\f':
+      w.put("\\f");
+      break;
+    case '\n':
+      w.put("\\n");
+      break;
+    case '\r':
+      w.put("\\r");
+      break;
+    case '\t':
+      w.put("\\t");
+      break;
+    default: {
+      char escaped[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+      w.put(std::string_view(escaped, sizeof(escaped)));
+      break;
+    }
+    }
+  }
+  w.put(value.substr(run));
+  w.put('"');
+}
+
+template <typename T>
+void write_members(const T &value, writer &w, const extra_member *extra) {
+  bool first = true;
+  auto separate = [&] {
+    if (!first) {
+      w.put(',');
+    }
+    first = false;
+  };
+  auto put_extra = [&] {
+    separate();
+    write_string(extra->key, w);
+    w.put(':');
+    write_string(extra->value, w);
+    extra = nullptr;
+  };
+  auto put_field = [&]<std::size_t I>(std::integral_constant<std::size_t, I>) {
+    const auto &field = boost::pfr::get<I>(value);
+    if (miniser::detail::skip_field<T>(field)) {
+      return;
+    }
+    separate();
+    w.put('"');
+    w.put(miniser::detail::name_of_field<I, T>);
+    w.put("\":");
+    write(field, w);
+  };
+
+  constexpr auto n_fields = boost::pfr::tuple_size_v<T>;
+  if (!w.canonical()) {
+    if (extra) {
+      put_extra();
+    }
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      (put_field(std::integral_constant<std::size_t, I>{}), ...);
+    }(std::make_index_sequence<n_fields>{});
+    return;
+  }
+
+  // the order of the fields is known at compile time, only the extra member
+  // is placed at runtime
+  auto put_sorted = [&]<std::size_t I>(std::integral_constant<std::size_t, I>) {
+    if (extra && extra->key < miniser::detail::name_of_field<I, T>) {
+      put_extra();
+    }
+    put_field(std::integral_constant<std::size_t, I>{});
+  };
+  [&]<std::size_t... K>(std::index_sequence<K...>) {
+    constexpr auto &order = miniser::detail::sorted_field_order<T>;
+    (put_sorted(std::integral_constant<std::size_t, order[K]>{}), ...);
+  }(std::make_index_sequence<n_fields>{});
+  if (extra) {
+    put_extra();
+  }
+}
+
+template <typename T> void write_integer(T value, writer &w) {
+  char buf[24];
+  auto res = std::to_chars(buf, buf + sizeof(buf), value);
+  w.put(std::string_view(buf, static_cast<std::size_t>(res.ptr - buf)));
+}
+
+/// Writes the shortest digits that round-trip as `T`, laid out like yyjson
+/// does: in fixed notation if the decimal point is at most 21 digits after
+/// the first digit and less than 6 zeros before it (integral values keep a
+/// fraction), otherwise as `d.ddde[-]N`.
+template <typename T> void write_real(T value, writer &w) {
+  // JSON can't represent these
+  if (!std::isfinite(value)) {
+    w.fail();
+    return;
+  }
+  if (w.canonical() && value == 0) {
+    // drops the sign of -0.0
+    value = 0;
+  }
+
+  // e.g. "-1.5e+300"
+  char sci[32];
+  auto res = std::to_chars(sci, sci + sizeof(sci), value,
+                           std::chars_format::scientific);
+  std::string_view text(sci, static_cast<std::size_t>(res.ptr - sci));
+  auto e = text.find('e');
+  auto exponent_text = text.substr(e + 1);
+  if (exponent_text.starts_with('+')) {
+    exponent_text.remove_prefix(1);
+  }
+  int exponent = 0;
+  std::from_chars(exponent_text.data(),
+                  exponent_text.data() + exponent_text.size(), exponent);
+
+  char buf[48];
+  char *out = buf;
+  auto mantissa = text.substr(0, e);
+  if (mantissa.starts_with('-')) {
+    *out++ = '-';
+    mantissa.remove_prefix(1);
+  }
+  char digits[24];
+  std::size_t n_digits = 0;
+  for (char c : mantissa) {
+    if (c != '.') {
+      digits[n_digits++] = c;
+    }
+  }
+  auto n = static_cast<int>(n_digits);
+
+  // number of digits before the decimal point
+  int point = exponent + 1;
+  if (point > -6 && point <= 21) {
+    if (point <= 0) {
+      out = std::fill_n(std::copy_n("0.", 2, out), -point, '0');
+      out = std::copy_n(digits, n, out);
+    } else if (point >= n) {
+      out = std::fill_n(std::copy_n(digits, n, out), point - n, '0');
+      out = std::copy_n(".0", 2, out);
+    } else {
+      out = std::copy_n(digits, point, out);
+      *out++ = '.';
+      out = std::copy_n(digits + point, n - point, out);
+    }
+  } else {
+    *out++ = digits[0];
+    if (n > 1) {
+      *out++ = '.';
+      out = std::copy_n(digits + 1, n - 1, out);
+    }
+    *out++ = 'e';
+    out = std::to_chars(out, buf + sizeof(buf), exponent).ptr;
+  }
+  w.put(std::string_view(buf, static_cast<std::size_t>(out - buf)));
+}
+
+} // namespace detail
+
+} // namespace stream
+
+/// Serializes `value` into `out` in chunks of (at most) `chunk_size` bytes.
+///
+/// Unlike `serialize`, no document is built and only a single chunk is held in
+/// memory, regardless of the size of `value`. Returns `false` if the value
+/// can't be serialized or the sink failed. Output that was already handed to
+/// the sink is not retracted.
+template <typename T, sink S>
+bool serialize_to_sink(const T &value, S &out,
+                       std::size_t chunk_size = 64 * 1024,
+                       stream::format fmt = stream::format::compact) {
+  std::vector<char> buffer(chunk_size == 0 ? 1 : chunk_size);
+  stream::writer w(out, buffer.data(), buffer.size(), fmt);
+  stream::write(value, w);
+  return w.flush();
+}
+
+/// Serializes `value` in the canonical format (see `stream::format`).
+///
+/// Fields are written in an order sorted at compile time, so no second pass
+/// over the output is needed to canonicalize it (e.g. before hashing it).
+template <typename T>
+std::optional<std::string> serialize_canonical(const T &value) {
+  std::string out;
+  auto append = callback_sink([&](std::string_view chunk) {
+    out.append(chunk);
+    return true;
+  });
+  if (!serialize_to_sink(value, append, 4096, stream::format::canonical)) {
+    return std::nullopt;
+  }
+  return out;
+}
+
+} // namespace miniser
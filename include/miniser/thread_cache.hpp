@@ -0,0 +1,244 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <yyjson.h>
+
+/// A per-thread cache of the memory used by yyjson documents.
+///
+/// When enabled (it's disabled by default), documents created by
+/// `serialize`, `deserialize` and their variants on a thread take their
+/// memory from the cache of that thread and return it when they're freed, so
+/// repeated calls don't go through the global allocator. Memory freed on
+/// another thread than the one that allocated it goes back to `free`. A
+/// document may outlive the thread it was created on: the cache of an exited
+/// thread is released with the last of its blocks.
+namespace miniser::thread_cache {
+
+namespace detail {
+
+/// The cache of a thread. It's shared by the thread and the blocks it
+/// allocated (which keep a reference through the `ctx` of the allocator of
+/// their document), so it's only destroyed once the thread has exited and
+/// all blocks are freed.
+class block_cache {
+  // blocks are rounded up to a power of two between 64 B and 32 MiB
+  static constexpr std::size_t min_shift = 6;
+  static constexpr std::size_t n_classes = 20;
+
+  struct alignas(std::max_align_t) header {
+    std::size_t size_class;
+  };
+
+  struct free_block {
+    free_block *next;
+  };
+
+  /// Owns the cache of a thread (for as long as the thread runs)
+  class handle {
+  public:
+    handle() : cache_(new block_cache) { current() = this->cache_; }
+    ~handle() {
+      current() = nullptr;
+      this->cache_->trim();
+      this->cache_->unref();
+    }
+    handle(const handle &) = delete;
+    handle(handle &&) = delete;
+    handle &operator=(const handle &) = delete;
+    handle &operator=(handle &&) = delete;
+
+    [[nodiscard]] block_cache &get() const { return *this->cache_; }
+
+  private:
+    block_cache *cache_;
+  };
+
+  block_cache() = default;
+  ~block_cache() = default;
+
+public:
+  block_cache(const block_cache &) = delete;
+  block_cache(block_cache &&) = delete;
+  block_cache &operator=(const block_cache &) = delete;
+  block_cache &operator=(block_cache &&) = delete;
+
+  /// The cache of the calling thread (`nullptr` if it wasn't created or the
+  /// thread is exiting). This never creates a cache.
+  static block_cache *&current() {
+    thread_local block_cache *cache = nullptr;
+    return cache;
+  }
+
+  /// The cache of the calling thread, which is created if needed
+  static block_cache &local() {
+    thread_local handle h;
+    return h.get();
+  }
+
+  [[nodiscard]] const yyjson_alc *allocator() const {
+    return this->limit_ > 0 ? &this->alc_ : nullptr;
+  }
+
+  void set_limit(std::size_t bytes) {
+    this->limit_ = bytes;
+    if (this->cached_ > bytes) {
+      this->trim();
+    }
+  }
+
+  void trim() {
+    for (auto &head : this->free_) {
+      while (head) {
+        auto *next = head->next;
+        // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+        std::free(to_header(head));
+        head = next;
+      }
+    }
+    this->cached_ = 0;
+  }
+
+  [[nodiscard]] std::size_t cached_bytes() const { return this->cached_; }
+
+private:
+  static std::size_t capacity(std::size_t size_class) {
+    return std::size_t{1} << (size_class + min_shift);
+  }
+
+  static std::size_t size_class_of(std::size_t size) {
+    std::size_t c = 0;
+    while (c < n_classes && capacity(c) < size) {
+      c++;
+    }
+    return c;
+  }
+
+  static header *to_header(void *ptr) {
+    return reinterpret_cast<header *>(static_cast<char *>(ptr) -
+                                      sizeof(header));
+  }
+
+  /// Whether the free lists may be used (only by the thread of the cache
+  /// while it runs)
+  bool owned() const { return current() == this; }
+
+  void unref() {
+    if (this->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  void *allocate(std::size_t size) {
+    auto c = size_class_of(size);
+    void *out = nullptr;
+    if (c < n_classes && this->owned() && this->free_[c]) {
+      auto *block = this->free_[c];
+      this->free_[c] = block->next;
+      this->cached_ -= capacity(c);
+      out = block;
+    } else {
+      // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+      auto *h = static_cast<header *>(std::malloc(
+          sizeof(header) + (c < n_classes ? capacity(c) : size)));
+      if (!h) {
+        return nullptr;
+      }
+      h->size_class = c;
+      out = h + 1;
+    }
+    // every block keeps the cache alive
+    this->refs_.fetch_add(1, std::memory_order_relaxed);
+    return out;
+  }
+
+  void release(void *ptr) {
+    if (!ptr) {
+      return;
+    }
+    auto *h = to_header(ptr);
+    auto c = h->size_class;
+    if (c < n_classes && this->owned() &&
+        this->cached_ + capacity(c) <= this->limit_) {
+      auto *block = static_cast<free_block *>(ptr);
+      block->next = this->free_[c];
+      this->free_[c] = block;
+      this->cached_ += capacity(c);
+    } else {
+      // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+      std::free(h);
+    }
+    this->unref();
+  }
+
+  void *reallocate(void *ptr, std::size_t old_size, std::size_t size) {
+    if (!ptr) {
+      return this->allocate(size);
+    }
+    auto c = to_header(ptr)->size_class;
+    if (c < n_classes && size <= capacity(c)) {
+      return ptr;
+    }
+    void *grown = this->allocate(size);
+    if (!grown) {
+      return nullptr;
+    }
+    std::memcpy(grown, ptr, old_size < size ? old_size : size);
+    this->release(ptr);
+    return grown;
+  }
+
+  /// The thread (while it runs) and every allocated block
+  std::atomic<std::size_t> refs_ = 1;
+  std::size_t limit_ = 0;
+  std::size_t cached_ = 0;
+  std::array<free_block *, n_classes> free_{};
+  yyjson_alc alc_{
+      .malloc = [](void *ctx, size_t size) {
+        return static_cast<block_cache *>(ctx)->allocate(size);
+      },
+      .realloc = [](void *ctx, void *ptr, size_t old_size, size_t size) {
+        return static_cast<block_cache *>(ctx)->reallocate(ptr, old_size,
+                                                           size);
+      },
+      .free = [](void *ctx,
+                 void *ptr) { static_cast<block_cache *>(ctx)->release(ptr); },
+      .ctx = this,
+  };
+};
+
+} // namespace detail
+
+/// Enables the cache of the calling thread and keeps at most `bytes` of freed
+/// memory for reuse (0 disables the cache).
+inline void set_limit(std::size_t bytes) {
+  if (bytes == 0 && !detail::block_cache::current()) {
+    return;
+  }
+  detail::block_cache::local().set_limit(bytes);
+}
+
+/// Frees all memory kept by the cache of the calling thread.
+inline void trim() {
+  if (auto *cache = detail::block_cache::current()) {
+    cache->trim();
+  }
+}
+
+/// Memory kept for reuse by the cache of the calling thread
+inline std::size_t cached_bytes() {
+  auto *cache = detail::block_cache::current();
+  return cache ? cache->cached_bytes() : 0;
+}
+
+/// Allocator for yyjson documents on the calling thread (`nullptr` if the
+/// cache is disabled)
+inline const yyjson_alc *allocator() {
+  auto *cache = detail::block_cache::current();
+  return cache ? cache->allocator() : nullptr;
+}
+
+} // namespace miniser::thread_cache
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <miniser/detail/scanner.hpp>
+#include <miniser/miniser.hpp>
+
+#include <array>
+#include <boost/pfr.hpp>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace miniser::schema {
+
+// The checks accept a superset of what `deser::deserialize` accepts. They only
+// look at the shape of the input (kinds of values, required fields) so they
+// can be done in a single pass over the text without allocating.
+
+using scanner = miniser::detail::scanner;
+
+namespace detail {
+
+template <typename T> struct is_optional : std::false_type {};
+template <typename T> struct is_optional<std::optional<T>> : std::true_type {};
+
+bool check_integer(scanner &sc, bool is_signed);
+
+template <typename T>
+bool check_field(std::size_t index, scanner &sc, std::size_t depth);
+
+} // namespace detail
+
+// Declarations
+
+bool check(std::type_identity<bool>, scanner &sc, std::size_t depth);
+
+template <typename T>
+  requires std::is_integral_v<T>
+bool check(std::type_identity<T>, scanner &sc, std::size_t depth);
+
+template <typename T>
+  requires std::is_floating_point_v<T>
+bool check(std::type_identity<T>, scanner &sc, std::size_t depth);
+
+bool check(std::type_identity<raw_number>, scanner &sc, std::size_t depth);
+
+bool check(std::type_identity<std::string>, scanner &sc, std::size_t depth);
+
+template <bytes_encoding E>
+bool check(std::type_identity<basic_bytes<E>>, scanner &sc, std::size_t depth);
+bool check(std::type_identity<std::string_view>, scanner &sc,
+           std::size_t depth);
+
+template <typename T>
+bool check(std::type_identity<std::vector<T>>, scanner &sc, std::size_t depth);
+
+template <typename T>
+  requires miniser::detail::is_object_v<T>
+bool check(std::type_identity<T>, scanner &sc, std::size_t depth);
+
+template <typename T>
+  requires has_codec<T>
+bool check(std::type_identity<T>, scanner &sc, std::size_t depth);
+
+template <typename T>
+bool check(std::type_identity<std::optional<T>>, scanner &sc,
+           std::size_t depth);
+
+/// Any other type (variants, raw JSON) only needs to be well-formed.
+template <typename T>
+bool check(std::type_identity<T>, scanner &sc, std::size_t depth);
+
+// Implementations
+
+inline bool check(std::type_identity<bool>, scanner &sc,
+                  std::size_t /*depth*/) {
+  if (sc.peek() == 't') {
+    return sc.scan_literal("true");
+  }
+  return sc.scan_literal("false");
+}
+
+template <typename T>
+  requires std::is_integral_v<T>
+bool check(std::type_identity<T>, scanner &sc, std::size_t /*depth*/) {
+  return detail::check_integer(sc, std::is_signed_v<T>);
+}
+
+template <typename T>
+  requires std::is_floating_point_v<T>
+bool check(std::type_identity<T>, scanner &sc, std::size_t /*depth*/) {
+  std::string_view raw;
+  return sc.scan_number(raw);
+}
+
+inline bool check(std::type_identity<raw_number>, scanner &sc,
+                  std::size_t /*depth*/) {
+  std::string_view raw;
+  return sc.scan_number(raw);
+}
+
+inline bool check(std::type_identity<std::string>, scanner &sc,
+                  std::size_t /*depth*/) {
+  std::string_view raw;
+  return sc.scan_string(raw);
+}
+
+inline bool check(std::type_identity<std::string_view>, scanner &sc,
+                  std::size_t /*depth*/) {
+  std::string_view raw;
+  return sc.scan_string(raw);
+}
+
+template <bytes_encoding E>
+bool check(std::type_identity<basic_bytes<E>>, scanner &sc,
+           std::size_t /*depth*/) {
+  std::string_view raw;
+  return sc.scan_string(raw);
+}
+
+template <typename T>
+bool check(std::type_identity<std::vector<T>>, scanner &sc, std::size_t depth) {
+  if (!sc.can_enter(depth) || !sc.consume('[')) {
+    return false;
+  }
+  if (sc.consume(']')) {
+    return true;
+  }
+  do {
+    if (!sc.count_element() ||
+        !check(std::type_identity<T>{}, sc, depth + 1)) {
+      return false;
+    }
+  } while (sc.consume(','));
+  return sc.consume(']');
+}
+
+template <typename T>
+  requires miniser::detail::is_object_v<T>
+bool check(std::type_identity<T>, scanner &sc, std::size_t depth) {
+  constexpr auto n_fields = boost::pfr::tuple_size_v<T>;
+
+  if (!sc.can_enter(depth) || !sc.consume('{')) {
+    return false;
+  }
+
+  std::array<bool, n_fields> seen{};
+  if (!sc.consume('}')) {
+    do {
+      std::string_view key;
+      if (!sc.count_element() || !sc.scan_string(key) || !sc.consume(':')) {
+        return false;
+      }
+
+      std::size_t index = 0;
+      if (key.find('\\') == std::string_view::npos) {
+        index = miniser::detail::field_index<T>(key);
+      } else {
+        index = miniser::detail::field_index<T>(miniser::detail::unescape(key));
+      }
+
+      // like `deser::deserialize`, only the first of duplicate keys is used
+      if (index < n_fields && !seen[index]) {
+        seen[index] = true;
+        if (!detail::check_field<T>(index, sc, depth + 1)) {
+          return false;
+        }
+      } else if (!sc.skip_value(depth + 1)) {
+        return false;
+      }
+    } while (sc.consume(','));
+
+    if (!sc.consume('}')) {
+      return false;
+    }
+  }
+
+  constexpr auto required = []<std::size_t... I>(std::index_sequence<I...>) {
+    return std::array<bool, sizeof...(I)>{
+        (!default_missing_fields<T> &&
+         !detail::is_optional<boost::pfr::tuple_element_t<I, T>>::value)...};
+  }(std::make_index_sequence<n_fields>{});
+  for (std::size_t i = 0; i < n_fields; i++) {
+    if (required[i] && !seen[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Only the kind of the value is checked, not whether the codec accepts it.
+template <typename T>
+  requires has_codec<T>
+bool check(std::type_identity<T>, scanner &sc, std::size_t depth) {
+  if constexpr (string_codec<T>) {
+    return check(std::type_identity<std::string_view>{}, sc, depth);
+  } else {
+    return check(std::type_identity<typename codec<T>::repr>{}, sc, depth);
+  }
+}
+
+/// Any value is accepted: `deser::deserialize` leaves an optional empty if
+/// its value doesn't match `T`.
+template <typename T>
+bool check(std::type_identity<std::optional<T>>, scanner &sc,
+           std::size_t depth) {
+  return sc.skip_value(depth);
+}
+
+template <typename T>
+bool check(std::type_identity<T>, scanner &sc, std::size_t depth) {
+  return sc.skip_value(depth);
+}
+
+namespace detail {
+
+inline bool check_integer(scanner &sc, bool is_signed) {
+  std::string_view raw;
+  if (!sc.scan_number(raw)) {
+    return false;
+  }
+  if (!is_signed && raw.starts_with('-')) {
+    return false;
+  }
+  return raw.find_first_of(".eE") == std::string_view::npos;
+}
+
+template <typename T, std::size_t I>
+bool check_field_at(scanner &sc, std::size_t depth) {
+  return check(std::type_identity<boost::pfr::tuple_element_t<I, T>>{}, sc,
+               depth);
+}
+
+template <typename T>
+bool check_field(std::size_t index, scanner &sc, std::size_t depth) {
+  using check_fn = bool (*)(scanner &, std::size_t);
+  constexpr auto table = []<std::size_t... I>(std::index_sequence<I...>) {
+    return std::array<check_fn, sizeof...(I)>{&check_field_at<T, I>...};
+  }(std::make_index_sequence<boost::pfr::tuple_size_v<T>>{});
+
+  return table[index](sc, depth);
+}
+
+} // namespace detail
+
+} // namespace miniser::schema
+
+namespace miniser {
+
+/// Checks that `str` has the shape of `T` and stays within `lims`.
+///
+/// This is a single pass over the input that stops at the first violation.
+/// It doesn't allocate (unless keys are escaped).
+template <typename T>
+bool matches_schema(std::string_view str, const limits &lims = {}) {
+  detail::scanner sc(str, lims);
+  return schema::check(std::type_identity<T>{}, sc, 0) && sc.at_end();
+}
+
+/// Like `deserialize`, but rejects inputs that don't match the shape of `T`
+/// or exceed `lims` before building a document.
+///
+/// Valid input is scanned and then parsed by yyjson, so it costs two passes:
+/// this trades some speed on valid input for not allocating a document for
+/// input that's rejected. Only standard JSON is accepted (no extensions
+/// enabled through `flags`).
+template <typename T>
+std::optional<T> deserialize_validated(std::string_view str,
+                                       const limits &lims = {},
+                                       const deser::context &ctx = {},
+                                       yyjson_read_flag flags = 0) {
+  if (!matches_schema<T>(str, lims)) {
+    return std::nullopt;
+  }
+  return deserialize<T>(str, ctx, flags);
+}
+
+} // namespace miniser
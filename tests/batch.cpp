@@ -0,0 +1,75 @@
+#include "miniser/batch.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace batch_test {
+
+struct Message {
+  std::uint32_t id;
+  std::string text;
+  std::optional<bool> ack;
+
+  bool operator==(const Message &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+
+std::vector<std::string> make_inputs(std::size_t n) {
+  std::vector<std::string> inputs;
+  for (std::size_t i = 0; i < n; i++) {
+    if (i % 7 == 3) {
+      inputs.emplace_back(R"({"id":"invalid"})");
+    } else {
+      auto id = std::to_string(i);
+      inputs.push_back(R"({"id":)" + id + R"(,"text":"message )" + id +
+                       R"("})");
+    }
+  }
+  return inputs;
+}
+
+void check_results(std::span<const std::string_view> inputs,
+                   std::span<std::optional<Message>> results) {
+  ASSERT_EQ(results.size(), inputs.size());
+  for (std::size_t i = 0; i < inputs.size(); i++) {
+    EXPECT_EQ(results[i], miniser::deserialize<Message>(inputs[i])) << i;
+  }
+}
+
+} // namespace batch_test
+
+using namespace batch_test;
+
+TEST(Batch, Decode) {
+  auto storage = make_inputs(50);
+  std::vector<std::string_view> inputs(storage.begin(), storage.end());
+
+  miniser::batch_decoder<Message> decoder;
+  check_results(inputs, decoder.decode(inputs));
+  EXPECT_FALSE(decoder.decode(inputs)[3].has_value());
+  EXPECT_EQ(decoder.decode(inputs)[4]->text, "message 4");
+
+  // results are reused
+  std::vector<std::string_view> fewer(inputs.begin(), inputs.begin() + 3);
+  check_results(fewer, decoder.decode(fewer));
+  EXPECT_TRUE(decoder.decode({}).empty());
+}
+
+TEST(Batch, Threads) {
+  auto storage = make_inputs(1000);
+  std::vector<std::string_view> inputs(storage.begin(), storage.end());
+
+  miniser::batch_decoder<Message> decoder;
+  for (std::size_t threads : {1, 2, 3, 8, 2000}) {
+    check_results(inputs, decoder.decode(inputs, threads));
+  }
+}
+
+TEST(Batch, InvalidJson) {
+  std::vector<std::string_view> inputs{"{", "", R"({"id":1,"text":""})"};
+  miniser::batch_decoder<Message> decoder;
+  auto results = decoder.decode(inputs);
+  EXPECT_FALSE(results[0].has_value());
+  EXPECT_FALSE(results[1].has_value());
+  EXPECT_EQ(results[2], (Message{1, "", std::nullopt}));
+}
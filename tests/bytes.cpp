@@ -0,0 +1,109 @@
+#include "equality.hpp"
+#include "miniser/plan.hpp"
+#include "miniser/stream.hpp"
+#include "miniser/validate.hpp"
+#include "sink.hpp"
+#include <gtest/gtest.h>
+
+namespace bytes_test {
+
+struct Blob {
+  miniser::bytes data;
+  miniser::hex_bytes digest;
+
+  bool operator==(const Blob &) const = default;
+};
+
+miniser::bytes from_string(std::string_view s) {
+  return miniser::bytes(std::as_bytes(std::span(s.data(), s.size())));
+}
+
+std::vector<std::byte> pattern(std::size_t n) {
+  std::vector<std::byte> out(n);
+  for (std::size_t i = 0; i < n; i++) {
+    out[i] = static_cast<std::byte>(i * 7 + (i >> 8));
+  }
+  return out;
+}
+
+} // namespace bytes_test
+
+template <>
+inline constexpr miniser::skip miniser::skip_fields<bytes_test::Blob> =
+    miniser::skip::empty;
+
+using namespace bytes_test;
+
+TEST(Bytes, Base64) {
+  // RFC 4648 test vectors
+  for (auto [in, out] : std::initializer_list<
+           std::pair<std::string_view, std::string_view>>{
+           {"", R"("")"},
+           {"f", R"("Zg==")"},
+           {"fo", R"("Zm8=")"},
+           {"foo", R"("Zm9v")"},
+           {"foob", R"("Zm9vYg==")"},
+           {"fooba", R"("Zm9vYmE=")"},
+           {"foobar", R"("Zm9vYmFy")"},
+       }) {
+    test_ser::check_eq(from_string(in), out);
+    test_deser::check_eq(out, std::optional(from_string(in)));
+  }
+}
+
+TEST(Bytes, Hex) {
+  miniser::hex_bytes h(std::vector<std::byte>{std::byte{0x00}, std::byte{0xab},
+                                              std::byte{0x7f}});
+  test_ser::check_eq(h, R"("00ab7f")");
+  test_deser::check_eq(R"("00ab7f")", std::optional(h));
+  test_deser::check_eq(R"("00AB7F")", std::optional(h));
+}
+
+TEST(Bytes, Invalid) {
+  test_deser::check_eq<miniser::bytes>(R"("Zg=")", std::nullopt);
+  test_deser::check_eq<miniser::bytes>(R"("Z===")", std::nullopt);
+  test_deser::check_eq<miniser::bytes>(R"("Zg=a")", std::nullopt);
+  test_deser::check_eq<miniser::bytes>(R"("Zm9v!mFy")", std::nullopt);
+  test_deser::check_eq<miniser::bytes>(R"("Zg==Zg==")", std::nullopt);
+  test_deser::check_eq<miniser::bytes>("[1]", std::nullopt);
+  test_deser::check_eq<miniser::hex_bytes>(R"("0")", std::nullopt);
+  test_deser::check_eq<miniser::hex_bytes>(R"("0g")", std::nullopt);
+
+  // an invalid character in the part decoded in blocks
+  std::string long_text = miniser::serialize(miniser::bytes(pattern(100)))
+                              ->to_string();
+  long_text[5] = '.';
+  test_deser::check_eq<miniser::bytes>(long_text, std::nullopt);
+}
+
+TEST(Bytes, RoundTrip) {
+  for (std::size_t n : {1, 2, 3, 11, 12, 13, 15, 16, 17, 47, 48, 49, 1000,
+                        5000}) {
+    SCOPED_TRACE(n);
+    Blob blob{miniser::bytes(pattern(n)), miniser::hex_bytes(pattern(n))};
+    auto text = miniser::serialize(blob);
+    ASSERT_TRUE(text.has_value());
+    EXPECT_EQ(miniser::deserialize<Blob>(text->view()), blob);
+    EXPECT_EQ(miniser::deserialize_planned<Blob>(text->view()), blob);
+    EXPECT_TRUE(miniser::matches_schema<Blob>(text->view()));
+
+    // the streaming writer encodes in blocks, and without the buffer if it's
+    // too small
+    static constexpr std::array<std::size_t, 3> sizes{1, 100, 4096};
+    test_stream::check_eq(blob, text->view(), sizes);
+  }
+}
+
+TEST(Bytes, DeserializeInto) {
+  miniser::bytes b(pattern(100));
+  const auto *storage = b.vec().data();
+  ASSERT_TRUE(miniser::deserialize_into(R"("Zm9vYmFy")", b));
+  EXPECT_EQ(b, from_string("foobar"));
+  // decoded into the existing storage
+  EXPECT_EQ(b.vec().data(), storage);
+}
+
+TEST(Bytes, SkipEmpty) {
+  test_ser::check_eq(Blob{}, "{}");
+  test_deser::check_eq("{}", std::optional(Blob{}));
+}
@@ -0,0 +1,179 @@
+#include "equality.hpp"
+#include "miniser/plan.hpp"
+#include "miniser/stream.hpp"
+#include "miniser/validate.hpp"
+#include "sink.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+
+namespace codec_test {
+
+// an aggregate that's written as a hex string instead of an object
+struct Uuid {
+  std::array<std::uint8_t, 16> bytes;
+
+  bool operator==(const Uuid &) const = default;
+};
+
+// cents, written as a number of cents
+struct Money {
+  std::int64_t cents;
+
+  bool operator==(const Money &) const = default;
+};
+
+// always needs escaping
+struct Quoted {
+  int n;
+
+  bool operator==(const Quoted &) const = default;
+};
+
+struct Order {
+  Uuid id;
+  std::vector<Money> prices;
+  std::optional<std::chrono::milliseconds> timeout;
+  Quoted quoted;
+
+  bool operator==(const Order &) const = default;
+};
+
+} // namespace codec_test
+
+template <> struct miniser::codec<codec_test::Uuid> {
+  static constexpr std::size_t max_size = 32;
+
+  static std::size_t encode(const codec_test::Uuid &v, char *out) {
+    static constexpr std::string_view hex = "0123456789abcdef";
+    for (auto b : v.bytes) {
+      *out++ = hex[b >> 4];
+      *out++ = hex[b & 0xF];
+    }
+    return max_size;
+  }
+
+  static std::optional<codec_test::Uuid> decode(std::string_view text) {
+    auto digit = [](char c) -> int {
+      if (c >= '0' && c <= '9') {
+        return c - '0';
+      }
+      if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+      }
+      return -1;
+    };
+    if (text.size() != max_size) {
+      return std::nullopt;
+    }
+    codec_test::Uuid out{};
+    for (std::size_t i = 0; i < out.bytes.size(); i++) {
+      int hi = digit(text[2 * i]);
+      int lo = digit(text[2 * i + 1]);
+      if (hi < 0 || lo < 0) {
+        return std::nullopt;
+      }
+      out.bytes[i] = static_cast<std::uint8_t>(hi << 4 | lo);
+    }
+    return out;
+  }
+};
+
+template <> struct miniser::codec<codec_test::Money> {
+  using repr = std::int64_t;
+  static repr encode(const codec_test::Money &v) { return v.cents; }
+  static std::optional<codec_test::Money> decode(repr r) {
+    return codec_test::Money{r};
+  }
+};
+
+template <> struct miniser::codec<std::chrono::milliseconds> {
+  using repr = std::int64_t;
+  static repr encode(std::chrono::milliseconds v) { return v.count(); }
+  static std::optional<std::chrono::milliseconds> decode(repr r) {
+    if (r < 0) {
+      return std::nullopt;
+    }
+    return std::chrono::milliseconds(r);
+  }
+};
+
+template <> struct miniser::codec<codec_test::Quoted> {
+  static constexpr std::size_t max_size = 16;
+
+  static std::size_t encode(const codec_test::Quoted &v, char *out) {
+    auto text = "\"" + std::to_string(v.n) + "\"";
+    text.copy(out, text.size());
+    return text.size();
+  }
+
+  static std::optional<codec_test::Quoted> decode(std::string_view text) {
+    if (text.size() < 2 || text.front() != '"' || text.back() != '"') {
+      return std::nullopt;
+    }
+    return codec_test::Quoted{std::stoi(std::string(text.substr(1)))};
+  }
+};
+
+using namespace codec_test;
+
+namespace {
+
+Order example() {
+  Order order{};
+  for (std::size_t i = 0; i < order.id.bytes.size(); i++) {
+    order.id.bytes[i] = static_cast<std::uint8_t>(i * 17);
+  }
+  order.prices = {{199}, {-5}};
+  order.timeout = std::chrono::milliseconds(1500);
+  order.quoted = {42};
+  return order;
+}
+
+constexpr std::string_view example_json =
+    R"({"id":"00112233445566778899aabbccddeeff","prices":[199,-5],)"
+    R"("timeout":1500,"quoted":"\"42\""})";
+
+} // namespace
+
+static_assert(miniser::string_codec<Uuid>);
+static_assert(miniser::mapped_codec<Money>);
+static_assert(!miniser::has_codec<Order>);
+
+TEST(Codec, Serialize) { test_ser::check_eq(example(), example_json); }
+
+TEST(Codec, Deserialize) {
+  test_deser::check_eq<Order>(example_json, example());
+
+  // the value must have the kind of the codec and be accepted by it
+  test_deser::check_eq<Uuid>(R"({"bytes":[]})", std::nullopt);
+  test_deser::check_eq<Uuid>(R"("0011")", std::nullopt);
+  test_deser::check_eq<Money>(R"("199")", std::nullopt);
+  test_deser::check_eq<std::chrono::milliseconds>("-1", std::nullopt);
+  test_deser::check_eq<std::chrono::milliseconds>(
+      "7", std::chrono::milliseconds(7));
+}
+
+TEST(Codec, DeserializeInto) {
+  Order order{};
+  ASSERT_TRUE(miniser::deserialize_into(example_json, order));
+  EXPECT_EQ(order, example());
+}
+
+TEST(Codec, Stream) {
+  // small chunks can't hold the encoded string
+  test_stream::check_eq(example(), example_json);
+}
+
+TEST(Codec, Plan) {
+  auto order = example();
+  EXPECT_EQ(miniser::serialize_planned(order)->view(), example_json);
+  EXPECT_EQ(miniser::deserialize_planned<Order>(example_json), order);
+}
+
+TEST(Codec, Validate) {
+  EXPECT_TRUE(miniser::matches_schema<Order>(example_json));
+  EXPECT_FALSE(miniser::matches_schema<Order>(
+      R"({"id":{"bytes":[]},"prices":[],"quoted":""})"));
+  EXPECT_FALSE(miniser::matches_schema<Order>(
+      R"({"id":"","prices":["1"],"quoted":""})"));
+}
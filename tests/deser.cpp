@@ -66,6 +66,32 @@ TEST(Deserialize, Double) {
   check_eq<double>("false", std::nullopt);
 }
 
+TEST(Deserialize, Float) {
+  check_eq<float>("1", 1);
+  check_eq<float>("1", std::nullopt, strict_real);
+  check_eq<float>("1.1", 1.1F);
+  check_eq<float>("-1.6", -1.6F);
+  check_eq<float>("1e300", std::numeric_limits<float>::infinity());
+  check_eq<float>("-1e300", -std::numeric_limits<float>::infinity());
+  check_eq<float>("1e300", std::nullopt, check_range);
+  check_eq<float>("-1e300", std::nullopt, check_range);
+  // rounds to the largest float
+  check_eq<float>("3.4028235e38", std::numeric_limits<float>::max());
+  check_eq<float>("-3.4028235e38", std::numeric_limits<float>::lowest(),
+                  check_range);
+  check_eq<float>("3.40282356e38", std::numeric_limits<float>::max(),
+                  check_range);
+  check_eq<float>("3.4028236e38", std::nullopt, check_range);
+  check_eq<float>("false", std::nullopt);
+}
+
+TEST(Deserialize, LongDouble) {
+  check_eq<long double>("42", 42);
+  check_eq<long double>("1.5", 1.5L);
+  check_eq<long double>("42", std::nullopt, strict_real);
+  check_eq<long double>("false", std::nullopt);
+}
+
 TEST(Deserialize, String) {
   check_eq<std::string>(R"("\"yo\"")", "\"yo\"");
   check_eq<std::string>("\"hello\"", "hello");
@@ -174,3 +200,95 @@ TEST(Deserialize, Vector) {
       R"([{"i":1,"f":true,"name":"abc"}, {"i":false,"f":false,"name":"def"}])",
       std::nullopt);
 }
+
+TEST(Deserialize, Into) {
+  std::vector<MaybeNested> out{
+      MaybeNested{1, "a long name that doesn't fit into the SSO buffer", true,
+                  Plain{2, "b", false}},
+      MaybeNested{3, "c", false, std::nullopt},
+      MaybeNested{4, "d", false, std::nullopt},
+  };
+  const auto *first_name = out[0].name.data();
+
+  ASSERT_TRUE(miniser::deserialize_into(
+      R"([{"i":5,"f":true,"name":"e"},)"
+      R"({"i":6,"f":false,"name":"f","p":{"i":7,"name":"g","f":true}}])",
+      out));
+  EXPECT_EQ(out, (std::vector{
+                     MaybeNested{5, "e", true, std::nullopt},
+                     MaybeNested{6, "f", false, Plain{7, "g", true}},
+                 }));
+  // the storage of the string was reused
+  EXPECT_EQ(out[0].name.data(), first_name);
+
+  EXPECT_FALSE(miniser::deserialize_into(R"([{"i":false}])", out));
+  EXPECT_FALSE(miniser::deserialize_into("[", out));
+}
+
+TEST(Deserialize, IntoVectorOfBool) {
+  std::vector<bool> bits{false, false, false, false};
+  ASSERT_TRUE(miniser::deserialize_into("[true,false,true]", bits));
+  EXPECT_EQ(bits, (std::vector<bool>{true, false, true}));
+  EXPECT_FALSE(miniser::deserialize_into("[true,1]", bits));
+
+  std::vector<std::vector<bool>> rows{{true}};
+  ASSERT_TRUE(miniser::deserialize_into("[[],[false,true]]", rows));
+  EXPECT_EQ(rows, (std::vector<std::vector<bool>>{{}, {false, true}}));
+}
+
+// const members make this not default-constructible
+struct Frozen {
+  const int id;
+  const std::string name;
+
+  bool operator==(const Frozen &other) const {
+    return id == other.id && name == other.name;
+  }
+};
+
+TEST(Deserialize, NotDefaultConstructible) {
+  static_assert(!std::is_default_constructible_v<Frozen>);
+
+  check_eq<Frozen>(R"({"id":1,"name":"a"})", Frozen{1, "a"});
+  check_eq<Frozen>(R"({"id":1})", std::nullopt);
+  check_eq<Frozen>(R"({"id":"1","name":"a"})", std::nullopt);
+  check_eq<std::vector<Frozen>>(R"([{"id":1,"name":"a"},{"id":2,"name":"b"}])",
+                                std::vector<Frozen>{{1, "a"}, {2, "b"}});
+  check_eq<std::optional<Frozen>>(R"({"id":1})",
+                                  std::optional<Frozen>(std::nullopt));
+}
+
+struct Gap {
+  int a;
+  std::optional<int> b;
+  int c;
+
+  bool operator==(const Gap &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+
+TEST(Deserialize, MemberOrder) {
+  // in order, reordered, with extra members and with duplicate keys (the
+  // first one wins)
+  check_eq<Plain>(R"({"i":1,"name":"a","f":true})", Plain{1, "a", true});
+  check_eq<Plain>(R"({"f":true,"name":"a","i":1})", Plain{1, "a", true});
+  check_eq<Plain>(R"({"i":1,"x":0,"name":"a","f":true})", Plain{1, "a", true});
+  check_eq<Plain>(R"({"name":"a","name":"b","i":1,"f":true})",
+                  Plain{1, "a", true});
+  check_eq<Plain>(R"({"i":1,"i":2,"name":"a","f":true})", Plain{1, "a", true});
+  check_eq<Plain>(R"({"name":"a","i":1,"name":"b","f":true})",
+                  Plain{1, "a", true});
+  check_eq<Frozen>(R"({"name":"a","id":1,"name":"b"})", Frozen{1, "a"});
+
+  // unknown members and members of previous fields are skipped
+  check_eq<Plain>(R"({"x":0,"i":1,"y":0,"name":"a","i":2,"f":true})",
+                  Plain{1, "a", true});
+
+  // a missing optional field doesn't stop the following fields from being
+  // found, and neither do members of later fields
+  check_eq<Gap>(R"({"a":1,"c":3})", Gap{1, std::nullopt, 3});
+  check_eq<Gap>(R"({"a":1,"x":0,"c":3})", Gap{1, std::nullopt, 3});
+  check_eq<Gap>(R"({"a":1,"c":3,"b":2})", Gap{1, 2, 3});
+  check_eq<Gap>(R"({"c":3,"b":2,"a":1})", Gap{1, 2, 3});
+}
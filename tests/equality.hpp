@@ -7,8 +7,9 @@ namespace test_deser {
 
 template <typename T>
 void check_eq(std::string_view in, std::optional<T> expected,
-              miniser::deser::option opts = miniser::deser::option::none) {
-  EXPECT_EQ(miniser::deserialize<T>(in, {opts}), expected) << in;
+              miniser::deser::option opts = miniser::deser::option::none,
+              yyjson_read_flag flags = 0) {
+  EXPECT_EQ(miniser::deserialize<T>(in, {opts}, flags), expected) << in;
 }
 
 template <typename T>
@@ -27,8 +28,9 @@ void check_borrowed_eq(
 
 namespace test_ser {
 
-template <typename T> void check_eq(T in, std::string_view expected) {
-  auto serialized = miniser::serialize<T>(in);
+template <typename T>
+void check_eq(T in, std::string_view expected, yyjson_write_flag flags = 0) {
+  auto serialized = miniser::serialize<T>(in, flags);
   EXPECT_TRUE(serialized.has_value()) << expected;
   EXPECT_EQ(serialized->view(), expected) << expected;
   EXPECT_EQ(serialized->view(), serialized->to_string()) << expected;
@@ -0,0 +1,63 @@
+#include "miniser/extract.hpp"
+#include <gtest/gtest.h>
+
+namespace extract_test {
+
+struct Meta {
+  std::string tenant;
+  int shard;
+
+  bool operator==(const Meta &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+
+constexpr std::string_view message =
+    R"({"meta": {"tenant": "acme", "shard": 3, "a/b": 1, "m~n": 2},)"
+    R"( "items": [10, [20, 21], {"x": true}], "": 0, "id": "é"})";
+
+} // namespace extract_test
+
+using namespace extract_test;
+
+TEST(Extract, Objects) {
+  EXPECT_EQ(miniser::extract<std::string>(message, "/meta/tenant"), "acme");
+  EXPECT_EQ(miniser::extract<int>(message, "/meta/shard"), 3);
+  EXPECT_EQ(miniser::extract<Meta>(message, "/meta"), (Meta{"acme", 3}));
+  EXPECT_EQ(miniser::extract<int>(message, "/meta/a~1b"), 1);
+  EXPECT_EQ(miniser::extract<int>(message, "/meta/m~0n"), 2);
+  EXPECT_EQ(miniser::extract<int>(message, "/"), 0);
+  EXPECT_EQ(miniser::extract<std::string>(message, "/id"), "é");
+  EXPECT_EQ(miniser::extract<std::string>(R"({"a":"b"})", "/a"), "b");
+}
+
+TEST(Extract, Arrays) {
+  EXPECT_EQ(miniser::extract<int>(message, "/items/0"), 10);
+  EXPECT_EQ(miniser::extract<int>(message, "/items/1/1"), 21);
+  EXPECT_EQ(miniser::extract<bool>(message, "/items/2/x"), true);
+  EXPECT_EQ(miniser::extract<std::vector<int>>(message, "/items/1"),
+            (std::vector<int>{20, 21}));
+}
+
+TEST(Extract, Root) {
+  EXPECT_EQ(miniser::extract<std::vector<int>>("[1,2]", ""),
+            (std::vector<int>{1, 2}));
+}
+
+TEST(Extract, Missing) {
+  EXPECT_FALSE(miniser::extract<int>(message, "/nope"));
+  EXPECT_FALSE(miniser::extract<int>(message, "/items/3"));
+  EXPECT_FALSE(miniser::extract<int>(message, "/items/01"));
+  EXPECT_FALSE(miniser::extract<int>(message, "/items/-"));
+  EXPECT_FALSE(miniser::extract<int>(message, "/meta/tenant/x"));
+  EXPECT_FALSE(miniser::extract<int>(message, "meta"));
+  EXPECT_FALSE(miniser::extract<int>(message, "/meta/~2"));
+  // wrong type
+  EXPECT_FALSE(miniser::extract<int>(message, "/meta/tenant"));
+}
+
+TEST(Extract, StopsEarly) {
+  // the input after the value isn't looked at
+  EXPECT_EQ(miniser::extract<int>(R"({"a":1,"b":)", "/a"), 1);
+  EXPECT_FALSE(miniser::extract<int>(R"({"a":[1,}],"b":2})", "/b"));
+}
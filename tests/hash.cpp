@@ -0,0 +1,57 @@
+#include "miniser/miniser.hpp"
+#include "miniser/hash.hpp"
+#include "sink.hpp"
+#include <gtest/gtest.h>
+
+namespace hash_test {
+
+struct Doc {
+  std::string id;
+  std::vector<int> values;
+};
+
+template <typename H> auto hash_of(std::string_view data) {
+  H h;
+  h.update(data);
+  return h.digest();
+}
+
+} // namespace hash_test
+
+using namespace hash_test;
+
+TEST(Hash, KnownValues) {
+  EXPECT_EQ(hash_of<miniser::fnv1a_64>(""), 0xcbf29ce484222325ULL);
+  EXPECT_EQ(hash_of<miniser::fnv1a_64>("a"), 0xaf63dc4c8601ec8cULL);
+  EXPECT_EQ(hash_of<miniser::crc32>(""), 0U);
+  EXPECT_EQ(hash_of<miniser::crc32>("123456789"), 0xCBF43926U);
+}
+
+TEST(Hash, Serialize) {
+  Doc doc{"doc", {1, 2, 3}};
+  auto expected = miniser::serialize(doc);
+  ASSERT_TRUE(expected.has_value());
+
+  auto fnv = miniser::serialize_hashed(doc);
+  ASSERT_TRUE(fnv.has_value());
+  EXPECT_EQ(fnv->text, expected->view());
+  EXPECT_EQ(fnv->digest, hash_of<miniser::fnv1a_64>(expected->view()));
+
+  auto crc = miniser::serialize_hashed<miniser::crc32>(doc);
+  ASSERT_TRUE(crc.has_value());
+  EXPECT_EQ(crc->digest, hash_of<miniser::crc32>(expected->view()));
+
+  auto canonical =
+      miniser::serialize_hashed(doc, miniser::stream::format::canonical);
+  ASSERT_TRUE(canonical.has_value());
+  EXPECT_EQ(canonical->text, miniser::serialize_canonical(doc));
+}
+
+TEST(Hash, Sink) {
+  std::string out;
+  auto append = test_stream::append_to(out);
+  miniser::hashing_sink<decltype(append), miniser::crc32> sink(append);
+  // chunks of 1 byte are hashed the same as the whole output
+  ASSERT_TRUE(miniser::serialize_to_sink(Doc{"x", {}}, sink, 1));
+  EXPECT_EQ(sink.hasher().digest(), hash_of<miniser::crc32>(out));
+}
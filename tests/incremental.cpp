@@ -0,0 +1,96 @@
+#include "equality.hpp"
+#include "miniser/incremental.hpp"
+#include <gtest/gtest.h>
+
+using miniser::decode_status;
+using miniser::incremental_decoder;
+
+namespace incremental_test {
+
+struct Plain {
+  int i;
+  std::string name;
+
+  bool operator==(const Plain &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+
+template <typename T>
+std::pair<decode_status, std::optional<T>> feed_bytes(std::string_view in,
+                                                      bool finish = false) {
+  incremental_decoder<T> decoder;
+  auto status = decode_status::need_more;
+  for (char c : in) {
+    status = decoder.feed({&c, 1});
+  }
+  if (finish) {
+    status = decoder.finish();
+  }
+  return {status, decoder.take()};
+}
+
+} // namespace incremental_test
+
+using namespace incremental_test;
+
+TEST(Incremental, Object) {
+  std::string_view in = R"({"i":1,"name":"a\"}{"})";
+  auto [status, value] = feed_bytes<Plain>(in);
+  EXPECT_EQ(status, decode_status::done);
+  EXPECT_EQ(value, (Plain{1, "a\"}{"}));
+
+  incremental_decoder<Plain> decoder;
+  EXPECT_EQ(decoder.feed(R"({"i":1,)"), decode_status::need_more);
+  EXPECT_EQ(decoder.feed(R"("name":"x"} )"), decode_status::done);
+  EXPECT_EQ(decoder.feed("\n"), decode_status::done);
+  EXPECT_EQ(decoder.feed("{}"), decode_status::error);
+}
+
+TEST(Incremental, Scalars) {
+  EXPECT_EQ(feed_bytes<int>("42").first, decode_status::need_more);
+  EXPECT_EQ(feed_bytes<int>("42", true).second, 42);
+  EXPECT_EQ(feed_bytes<int>("42 ").second, 42);
+  EXPECT_EQ(feed_bytes<std::string>(R"("a b")").second, "a b");
+  EXPECT_EQ(feed_bytes<int>("4 2", true).first, decode_status::error);
+  EXPECT_EQ(feed_bytes<std::string>(R"("a" "b")").first,
+            decode_status::error);
+}
+
+TEST(Incremental, Vector) {
+  auto [status, value] = feed_bytes<std::vector<Plain>>(
+      R"([{"i":1,"name":"]"}, {"i":2,"name":"[,"}])");
+  EXPECT_EQ(status, decode_status::done);
+  EXPECT_EQ(value, (std::vector<Plain>{{1, "]"}, {2, "[,"}}));
+
+  EXPECT_EQ(feed_bytes<std::vector<int>>("[ ]").second, std::vector<int>{});
+  EXPECT_EQ(feed_bytes<std::vector<std::vector<int>>>("[[1,2],[]]").second,
+            (std::vector<std::vector<int>>{{1, 2}, {}}));
+  EXPECT_EQ(feed_bytes<std::vector<int>>("[1,]").first, decode_status::error);
+  EXPECT_EQ(feed_bytes<std::vector<int>>("[,1]").first, decode_status::error);
+  EXPECT_EQ(feed_bytes<std::vector<int>>("[1,\"2\"]").first,
+            decode_status::error);
+  EXPECT_EQ(feed_bytes<std::vector<int>>("{}").first, decode_status::error);
+  EXPECT_EQ(feed_bytes<std::vector<int>>("[1,2").first,
+            decode_status::need_more);
+}
+
+TEST(Incremental, VectorDecodesEarly) {
+  incremental_decoder<std::vector<int>> decoder;
+  EXPECT_EQ(decoder.feed("[1,"), decode_status::need_more);
+  // the second element is invalid, which is detected before the array ends
+  EXPECT_EQ(decoder.feed("false,"), decode_status::error);
+}
+
+TEST(Incremental, MismatchedBrackets) {
+  EXPECT_EQ(feed_bytes<std::vector<int>>("[1,2}").first, decode_status::error);
+  EXPECT_EQ(feed_bytes<std::vector<std::vector<int>>>("[[1,2},[3]]").first,
+            decode_status::error);
+  EXPECT_EQ(feed_bytes<Plain>(R"({"i":1,"name":"a"])").first,
+            decode_status::error);
+  EXPECT_EQ(feed_bytes<std::vector<Plain>>(R"([{"i":1,"name":"a"]])").first,
+            decode_status::error);
+  // brackets in strings don't count
+  EXPECT_EQ(feed_bytes<std::vector<std::string>>(R"(["}", "]"])").first,
+            decode_status::done);
+}
@@ -0,0 +1,46 @@
+#include "instantiate_types.hpp"
+#include <gtest/gtest.h>
+
+// The codecs are instantiated in instantiate_types.cpp
+
+using namespace instantiate_test;
+
+TEST(Instantiate, Serialize) {
+  Table table{
+      .name = "t",
+      .entries = {{"a", 1}, {"b", std::nullopt}},
+  };
+  auto s = miniser::serialize(table);
+  ASSERT_TRUE(s.has_value());
+  EXPECT_EQ(s->view(),
+            R"({"name":"t","entries":[{"key":"a","value":1},)"
+            R"({"key":"b","value":null}]})");
+
+  auto entries = miniser::serialize(table.entries);
+  ASSERT_TRUE(entries.has_value());
+  EXPECT_EQ(entries->view(),
+            R"([{"key":"a","value":1},{"key":"b","value":null}])");
+}
+
+TEST(Instantiate, Deserialize) {
+  auto table = miniser::deserialize<Table>(
+      R"({"name":"t","entries":[{"key":"a","value":1}]})");
+  ASSERT_TRUE(table.has_value());
+  EXPECT_EQ(table->name, "t");
+  ASSERT_EQ(table->entries.size(), 1U);
+  EXPECT_EQ(table->entries[0].key, "a");
+  EXPECT_EQ(table->entries[0].value, 1);
+
+  EXPECT_FALSE(miniser::deserialize<Entry>(R"({"value":1})").has_value());
+
+  ASSERT_TRUE(miniser::deserialize_into(
+      R"({"name":"u","entries":[{"key":"b"},{"key":"c","value":2}]})",
+      *table));
+  EXPECT_EQ(table->name, "u");
+  ASSERT_EQ(table->entries.size(), 2U);
+  EXPECT_EQ(table->entries[1].value, 2);
+
+  auto borrowed = miniser::deserialize_borrowed<Entry>(R"({"key":"k"})");
+  ASSERT_TRUE(borrowed.has_value());
+  EXPECT_EQ((*borrowed)->key, "k");
+}
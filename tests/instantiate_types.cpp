@@ -0,0 +1,5 @@
+#include "instantiate_types.hpp"
+
+MINISER_DEFINE_CODEC(instantiate_test::Entry);
+MINISER_DEFINE_CODEC(instantiate_test::Table);
+MINISER_DEFINE_CODEC(std::vector<instantiate_test::Entry>);
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "miniser/instantiate.hpp"
+
+namespace instantiate_test {
+
+struct Entry {
+  std::string key;
+  std::optional<std::int64_t> value;
+};
+
+struct Table {
+  std::string name;
+  std::vector<Entry> entries;
+};
+
+} // namespace instantiate_test
+
+MINISER_DECLARE_CODEC(instantiate_test::Entry);
+MINISER_DECLARE_CODEC(instantiate_test::Table);
+MINISER_DECLARE_CODEC(std::vector<instantiate_test::Entry>);
@@ -0,0 +1,111 @@
+#include "miniser/miniser.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+
+static_assert(miniser::metrics::enabled);
+
+namespace metrics_test {
+
+struct Ping {
+  int seq;
+};
+
+struct Pong {
+  int seq;
+};
+
+std::vector<miniser::metrics::event> events;
+
+void record(const miniser::metrics::event &ev) { events.push_back(ev); }
+
+/// The counters of `T` since `before` (the counters are process-wide, so
+/// tests only look at the calls they make)
+template <typename T>
+miniser::metrics::counters since(const miniser::metrics::counters &before) {
+  auto after = miniser::metrics::stats<T>();
+  after.calls -= before.calls;
+  after.failures -= before.failures;
+  after.bytes_in -= before.bytes_in;
+  after.bytes_out -= before.bytes_out;
+  after.parse_ns -= before.parse_ns;
+  after.convert_ns -= before.convert_ns;
+  after.allocations -= before.allocations;
+  return after;
+}
+
+std::uint64_t calls_of(std::string_view type) {
+  std::uint64_t calls = 0;
+  miniser::metrics::for_each_type(
+      [&](std::string_view name, const miniser::metrics::counters &counters) {
+        if (name == type) {
+          calls = counters.calls;
+        }
+      });
+  return calls;
+}
+
+} // namespace metrics_test
+
+using namespace metrics_test;
+
+TEST(Metrics, Counters) {
+  auto ping = miniser::metrics::stats<Ping>();
+  auto pong = miniser::metrics::stats<Pong>();
+  auto s = miniser::serialize(Ping{1});
+  ASSERT_TRUE(s.has_value());
+  EXPECT_TRUE(miniser::deserialize<Ping>(s->view()).has_value());
+  EXPECT_FALSE(miniser::deserialize<Ping>("{}").has_value());
+  EXPECT_FALSE(miniser::deserialize<Ping>("{").has_value());
+
+  auto stats = since<Ping>(ping);
+  EXPECT_EQ(stats.calls, 4U);
+  EXPECT_EQ(stats.failures, 2U);
+  EXPECT_EQ(stats.bytes_out, s->view().size());
+  EXPECT_EQ(stats.bytes_in, s->view().size() + 3U);
+  EXPECT_GT(stats.allocations, 0U);
+
+  EXPECT_EQ(since<Pong>(pong).calls, 0U);
+}
+
+TEST(Metrics, Threads) {
+  auto pong = miniser::metrics::stats<Pong>();
+  auto pong_calls = calls_of("Pong");
+  std::thread([] {
+    EXPECT_TRUE(miniser::deserialize<Pong>(R"({"seq":1})").has_value());
+  }).join();
+  EXPECT_TRUE(miniser::deserialize<Pong>(R"({"seq":2})").has_value());
+
+  auto stats = since<Pong>(pong);
+  EXPECT_EQ(stats.calls, 2U);
+  EXPECT_EQ(stats.failures, 0U);
+  EXPECT_EQ(calls_of("Pong"), pong_calls + 2);
+}
+
+TEST(Metrics, Sink) {
+  events.clear();
+  miniser::metrics::set_sink(record);
+  EXPECT_FALSE(miniser::deserialize_borrowed<Ping>("1").has_value());
+  miniser::metrics::set_sink(nullptr);
+  EXPECT_TRUE(miniser::serialize(Ping{1}).has_value());
+
+  ASSERT_EQ(events.size(), 1U);
+  EXPECT_EQ(events[0].op, miniser::metrics::operation::deserialize_borrowed);
+  EXPECT_EQ(events[0].type, "Ping");
+  EXPECT_FALSE(events[0].ok);
+  EXPECT_EQ(events[0].bytes_in, 1U);
+}
+
+TEST(Metrics, BorrowedOutlivesProbe) {
+  auto ping = miniser::metrics::stats<Ping>();
+  auto borrowed = miniser::deserialize_borrowed<Ping>(R"({"seq":3})");
+  ASSERT_TRUE(borrowed.has_value());
+
+  // the document is freed after the probe of the call is gone, so it isn't
+  // allocated through the probe (and its allocations aren't counted)
+  EXPECT_EQ((*borrowed)->seq, 3);
+  borrowed.reset();
+
+  auto stats = since<Ping>(ping);
+  EXPECT_EQ(stats.calls, 1U);
+  EXPECT_EQ(stats.allocations, 0U);
+}
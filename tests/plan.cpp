@@ -0,0 +1,127 @@
+#include "equality.hpp"
+#include "miniser/plan.hpp"
+#include <gtest/gtest.h>
+
+namespace plan_test {
+
+struct Point {
+  int x;
+  int y;
+};
+
+struct Shape {
+  std::string name;
+  std::vector<Point> points;
+  std::optional<Point> center;
+  std::optional<std::string> label;
+  std::variant<int, std::string> id;
+  double area;
+  bool closed;
+};
+
+struct Scene {
+  std::vector<Shape> shapes;
+  std::uint64_t version;
+};
+
+struct Flags {
+  std::vector<bool> bits;
+  std::vector<std::vector<bool>> rows;
+};
+
+Scene example() {
+  return {
+      .shapes =
+          {
+              {
+                  .name = "triangle",
+                  .points = {{0, 0}, {4, 0}, {0, 3}},
+                  .center = Point{1, 1},
+                  .label = std::nullopt,
+                  .id = 7,
+                  .area = 6.0,
+                  .closed = true,
+              },
+              {
+                  .name = "line",
+                  .points = {{-1, -1}, {1, 1}},
+                  .center = std::nullopt,
+                  .label = "diagonal",
+                  .id = "l-1",
+                  .area = 0.0,
+                  .closed = false,
+              },
+          },
+      .version = 18446744073709551615ULL,
+  };
+}
+
+} // namespace plan_test
+
+using namespace plan_test;
+
+TEST(Plan, SerializeSameAsTemplated) {
+  auto scene = example();
+  auto expected = miniser::serialize(scene);
+  auto planned = miniser::serialize_planned(scene);
+  ASSERT_TRUE(expected.has_value());
+  ASSERT_TRUE(planned.has_value());
+  EXPECT_EQ(planned->view(), expected->view());
+
+  auto empty = miniser::serialize_planned(Scene{});
+  ASSERT_TRUE(empty.has_value());
+  EXPECT_EQ(empty->view(), R"({"shapes":[],"version":0})");
+}
+
+TEST(Plan, DeserializeSameAsTemplated) {
+  auto text = miniser::serialize(example());
+  ASSERT_TRUE(text.has_value());
+
+  auto planned = miniser::deserialize_planned<Scene>(text->view());
+  ASSERT_TRUE(planned.has_value());
+  EXPECT_EQ(miniser::serialize(*planned)->view(), text->view());
+}
+
+TEST(Plan, DeserializeOptional) {
+  // missing, null and invalid optionals are empty, like in `deserialize`
+  auto p = miniser::deserialize_planned<Shape>(
+      R"({"name":"a","points":[],"center":{"x":1},"id":1,"area":1,"closed":true})");
+  ASSERT_TRUE(p.has_value());
+  EXPECT_FALSE(p->center.has_value());
+  EXPECT_FALSE(p->label.has_value());
+
+  p = miniser::deserialize_planned<Shape>(
+      R"({"name":"a","points":[],"label":null,"id":"x","area":1,"closed":true})");
+  ASSERT_TRUE(p.has_value());
+  EXPECT_FALSE(p->label.has_value());
+  EXPECT_EQ(p->id, (std::variant<int, std::string>("x")));
+}
+
+TEST(Plan, DeserializeInvalid) {
+  EXPECT_FALSE(miniser::deserialize_planned<Point>("[]").has_value());
+  EXPECT_FALSE(miniser::deserialize_planned<Point>(R"({"x":1})").has_value());
+  EXPECT_FALSE(
+      miniser::deserialize_planned<Point>(R"({"x":1,"y":"2"})").has_value());
+  EXPECT_FALSE(miniser::deserialize_planned<Scene>(
+                   R"({"shapes":[{"name":1}],"version":1})")
+                   .has_value());
+  EXPECT_FALSE(miniser::deserialize_planned<Point>("{").has_value());
+}
+
+TEST(Plan, Fields) {
+  auto fields = miniser::plan::detail::fields_of<Point>();
+  ASSERT_EQ(fields.size(), 2U);
+  EXPECT_EQ(fields[0].offset, offsetof(Point, x));
+  EXPECT_EQ(fields[1].offset, offsetof(Point, y));
+}
+
+TEST(Plan, VectorOfBool) {
+  std::string_view text = R"({"bits":[true,false,true],"rows":[[],[false]]})";
+  auto flags = miniser::deserialize_planned<Flags>(text);
+  ASSERT_TRUE(flags.has_value());
+  EXPECT_EQ(flags->bits, (std::vector<bool>{true, false, true}));
+  EXPECT_EQ(flags->rows, (std::vector<std::vector<bool>>{{}, {false}}));
+  EXPECT_EQ(miniser::serialize_planned(*flags)->view(), text);
+  EXPECT_FALSE(miniser::deserialize_planned<Flags>(R"({"bits":[1],"rows":[]})")
+                   .has_value());
+}
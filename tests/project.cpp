@@ -0,0 +1,75 @@
+#include "miniser/project.hpp"
+#include <gtest/gtest.h>
+
+namespace project_test {
+
+struct Event {
+  std::uint64_t id;
+  std::string source;
+  std::vector<std::string> tags;
+  std::optional<std::string> note;
+  std::int64_t ts;
+};
+
+struct EventKey {
+  std::uint64_t id;
+  std::int64_t ts;
+
+  bool operator==(const EventKey &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+
+constexpr std::string_view event =
+    R"({"id":7,"source":"sensor","tags":["a","b",{"nested":[1,2]}],)"
+    R"("payload":{"big":[1,2,3],"s":"x\"y"}, "ts" : -5, "note":null})";
+
+} // namespace project_test
+
+using namespace project_test;
+
+TEST(Project, SlimStruct) {
+  EXPECT_EQ(miniser::deserialize_projected<EventKey>(event),
+            (EventKey{7, -5}));
+  // escaped keys are matched
+  EXPECT_EQ(miniser::deserialize_projected<EventKey>(
+                R"({"\u0069d":1,"ts":2,"other":[]})"),
+            (EventKey{1, 2}));
+  // the first occurrence is used, like in deserialize
+  EXPECT_EQ(miniser::deserialize_projected<EventKey>(
+                R"({"id":1,"ts":2,"id":3})"),
+            (EventKey{1, 2}));
+}
+
+TEST(Project, SlimStructInvalid) {
+  EXPECT_FALSE(miniser::deserialize_projected<EventKey>(R"({"id":1})"));
+  EXPECT_FALSE(
+      miniser::deserialize_projected<EventKey>(R"({"id":1,"ts":"2"})"));
+  // skipped values have to be valid as well
+  EXPECT_FALSE(miniser::deserialize_projected<EventKey>(
+      R"({"id":1,"ts":2,"other":[1,}"})"));
+  EXPECT_FALSE(miniser::deserialize_projected<EventKey>(R"({"id":1,"ts":2})"
+                                                        "x"));
+  EXPECT_FALSE(miniser::deserialize_projected<EventKey>("[]"));
+}
+
+TEST(Project, MemberPointers) {
+  auto e = miniser::deserialize_fields<Event, &Event::id, &Event::ts>(event);
+  ASSERT_TRUE(e.has_value());
+  EXPECT_EQ(e->id, 7U);
+  EXPECT_EQ(e->ts, -5);
+  EXPECT_TRUE(e->source.empty());
+  EXPECT_TRUE(e->tags.empty());
+
+  auto tags = miniser::deserialize_fields<Event, &Event::tags>(
+      R"({"tags":["x","y"],"id":"not checked"})");
+  ASSERT_TRUE(tags.has_value());
+  EXPECT_EQ(tags->tags, (std::vector<std::string>{"x", "y"}));
+
+  EXPECT_FALSE((miniser::deserialize_fields<Event, &Event::id>("{}")));
+  EXPECT_FALSE(
+      (miniser::deserialize_fields<Event, &Event::id>(R"({"id":-1})")));
+  auto note = miniser::deserialize_fields<Event, &Event::note>("{}");
+  ASSERT_TRUE(note.has_value());
+  EXPECT_FALSE(note->note.has_value());
+}
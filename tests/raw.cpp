@@ -0,0 +1,184 @@
+#include "equality.hpp"
+#include <gtest/gtest.h>
+
+using miniser::raw_number;
+
+constexpr auto none = miniser::deser::option::none;
+
+struct Payment {
+  std::uint64_t id;
+  raw_number amount;
+
+  bool operator==(const Payment &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+
+TEST(RawNumber, Serialize) {
+  test_ser::check_eq(raw_number("123456789012345678901234567890"),
+                     "123456789012345678901234567890");
+  test_ser::check_eq(Payment{1, raw_number("0.10000000000000000001")},
+                     R"({"id":1,"amount":0.10000000000000000001})");
+  EXPECT_FALSE(miniser::serialize(raw_number()).has_value());
+}
+
+TEST(RawNumber, Deserialize) {
+  test_deser::check_eq<raw_number>("123456789012345678901234567890",
+                                   raw_number("123456789012345678901234567890"),
+                                   none, YYJSON_READ_BIGNUM_AS_RAW);
+  test_deser::check_eq<raw_number>("1.50", raw_number("1.50"), none,
+                                   YYJSON_READ_NUMBER_AS_RAW);
+  test_deser::check_eq<raw_number>("42", raw_number("42"));
+  test_deser::check_eq<raw_number>("\"42\"", std::nullopt);
+  test_deser::check_eq<raw_number>("null", std::nullopt);
+
+  test_deser::check_eq<Payment>(
+      R"({"id":1,"amount":123456789012345678901234567890})",
+      Payment{1, raw_number("123456789012345678901234567890")}, none,
+      YYJSON_READ_BIGNUM_AS_RAW);
+}
+
+struct Quote {
+  std::int32_t qty;
+  std::uint8_t lot;
+  double price;
+  float fee;
+  raw_number amount;
+
+  bool operator==(const Quote &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+
+TEST(RawNumber, OtherNumbers) {
+  // integers and reals next to a raw number are parsed from their text
+  std::string_view in =
+      R"({"qty":-3,"lot":200,"price":1.25,"fee":2,"amount":1.50})";
+  Quote expected{-3, 200, 1.25, 2, raw_number("1.50")};
+  test_deser::check_eq<Quote>(in, expected, none, YYJSON_READ_NUMBER_AS_RAW);
+  test_deser::check_eq<Quote>(
+      R"({"qty":-3,"lot":200,"price":1.25,"fee":2,"amount":1e400})",
+      Quote{-3, 200, 1.25, 2, raw_number("1e400")}, none,
+      YYJSON_READ_BIGNUM_AS_RAW);
+
+  // the same checks as for other numbers
+  test_deser::check_eq<Quote>(
+      R"({"qty":1.5,"lot":200,"price":1.25,"fee":2,"amount":1})",
+      std::nullopt, none, YYJSON_READ_NUMBER_AS_RAW);
+  test_deser::check_eq<Quote>(
+      R"({"qty":-3,"lot":-1,"price":1.25,"fee":2,"amount":1})",
+      std::nullopt, none, YYJSON_READ_NUMBER_AS_RAW);
+  test_deser::check_eq<Quote>(
+      R"({"qty":-3,"lot":256,"price":1.25,"fee":2,"amount":1})",
+      std::nullopt, miniser::deser::option::check_range,
+      YYJSON_READ_NUMBER_AS_RAW);
+  test_deser::check_eq<Quote>(
+      R"({"qty":-3,"lot":200,"price":1.25,"fee":2,"amount":1})",
+      std::nullopt, miniser::deser::option::strict_real,
+      YYJSON_READ_NUMBER_AS_RAW);
+}
+
+TEST(RawNumber, RoundTrip) {
+  std::string_view in = R"({"id":7,"amount":18446744073709551616})";
+  auto payment =
+      miniser::deserialize<Payment>(in, {}, YYJSON_READ_BIGNUM_AS_RAW);
+  ASSERT_TRUE(payment.has_value());
+  auto out = miniser::serialize(*payment);
+  ASSERT_TRUE(out.has_value());
+  EXPECT_EQ(out->view(), in);
+}
+
+struct Envelope {
+  std::string kind;
+  miniser::raw_json payload;
+
+  bool operator==(const Envelope &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+
+struct EnvelopeView {
+  std::string_view kind;
+  miniser::raw_json_view payload;
+};
+
+TEST(RawJson, Serialize) {
+  test_ser::check_eq(miniser::raw_json(R"({"a":[1,2]})"), R"({"a":[1,2]})");
+  test_ser::check_eq(Envelope{"x", miniser::raw_json(R"([1, {"b" : null}])")},
+                     R"({"kind":"x","payload":[1, {"b" : null}]})");
+  EXPECT_FALSE(miniser::serialize(miniser::raw_json()).has_value());
+}
+
+TEST(RawJson, Deserialize) {
+  test_deser::check_eq<Envelope>(
+      R"({"kind":"x","payload":{"a": [1, 2], "b": {"c": "d"}}})",
+      Envelope{"x", miniser::raw_json(R"({"a": [1, 2], "b": {"c": "d"}})")});
+  test_deser::check_eq<Envelope>(R"({"kind":"x","payload":null})",
+                                 Envelope{"x", miniser::raw_json("null")});
+  test_deser::check_eq<Envelope>(R"({"kind":"x"})", std::nullopt);
+}
+
+TEST(RawJson, Borrowed) {
+  std::string_view in = R"({"kind":"x","payload":{"a":[1,2],"b":{"c":"d"}}})";
+  auto envelope = miniser::deserialize_borrowed<EnvelopeView>(in);
+  ASSERT_TRUE(envelope.has_value());
+  EXPECT_EQ((*envelope)->kind, "x");
+  EXPECT_TRUE(yyjson_is_obj((*envelope)->payload.value()));
+
+  auto out = miniser::serialize(**envelope);
+  ASSERT_TRUE(out.has_value());
+  EXPECT_EQ(out->view(), in);
+}
+
+TEST(RawJson, KeepsText) {
+  std::string_view in =
+      R"({"kind":"x","payload": { "s" : "\u00e9\n", "n" : [1.0E2, -0] } })";
+  std::string_view payload = R"({ "s" : "\u00e9\n", "n" : [1.0E2, -0] })";
+
+  auto envelope = miniser::deserialize<Envelope>(in);
+  ASSERT_TRUE(envelope.has_value());
+  EXPECT_EQ(envelope->payload.view(), payload);
+  auto out = miniser::serialize(*envelope);
+  ASSERT_TRUE(out.has_value());
+  EXPECT_EQ(out->view(),
+            R"({"kind":"x","payload":)" + std::string(payload) + "}");
+
+  auto view = miniser::deserialize_borrowed<EnvelopeView>(in);
+  ASSERT_TRUE(view.has_value());
+  EXPECT_EQ((*view)->payload.text(), payload);
+  auto view_out = miniser::serialize(**view);
+  ASSERT_TRUE(view_out.has_value());
+  EXPECT_EQ(view_out->view(), out->view());
+
+  // without the text (e.g. with comments), the value is re-encoded
+  auto commented = miniser::deserialize<Envelope>(
+      R"({"kind":"x","payload":/* c */ [1.0E2, "\u00e9"]})", {},
+      YYJSON_READ_ALLOW_COMMENTS);
+  ASSERT_TRUE(commented.has_value());
+  EXPECT_EQ(commented->payload.view(), "[100.0,\"é\"]");
+}
+
+struct TwoRaw {
+  miniser::raw_json first;
+  miniser::raw_json second;
+
+  bool operator==(const TwoRaw &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+
+TEST(RawJson, Order) {
+  // raw values in the order of the input are found in a single scan
+  test_deser::check_eq<std::vector<miniser::raw_json>>(
+      "[ 1.0 , [ 2 ] , {} ]",
+      std::vector<miniser::raw_json>{miniser::raw_json("1.0"),
+                                     miniser::raw_json("[ 2 ]"),
+                                     miniser::raw_json("{}")});
+  test_deser::check_eq<TwoRaw>(
+      R"({"first":[ 1 ],"second":{ "x" : 2 }})",
+      TwoRaw{miniser::raw_json("[ 1 ]"), miniser::raw_json(R"({ "x" : 2 })")});
+  // a value before the previous one is found by scanning again
+  test_deser::check_eq<TwoRaw>(
+      R"({"second":{ "x" : 2 },"first":[ 1 ]})",
+      TwoRaw{miniser::raw_json("[ 1 ]"), miniser::raw_json(R"({ "x" : 2 })")});
+}
@@ -49,6 +49,25 @@ TEST(Serialize, Double) {
   check_eq<double>(-1.6, "-1.6");
 }
 
+TEST(Serialize, Float) {
+  check_eq<float>(1, "1.0");
+  check_eq<float>(1.1F, "1.1");
+  check_eq<float>(-1.6F, "-1.6");
+  check_eq<float>(0.3F, "0.3");
+}
+
+TEST(Serialize, LongDouble) {
+  check_eq<long double>(1, "1.0");
+  check_eq<long double>(1.1L, "1.1");
+}
+
+TEST(Serialize, RealFlags) {
+  check_eq<double>(0.1, "0.1", YYJSON_WRITE_FP_TO_FLOAT);
+  check_eq<double>(1.0 / 3.0, "0.33333334", YYJSON_WRITE_FP_TO_FLOAT);
+  check_eq<double>(1.0 / 3.0, "0.33", YYJSON_WRITE_FP_TO_FIXED(2));
+  check_eq<double>(42, "42.0", YYJSON_WRITE_FP_TO_FIXED(2));
+}
+
 TEST(Serialize, String) {
   check_eq<std::string>("\"yo\"", R"("\"yo\"")");
   check_eq<std::string>("hello", "\"hello\"");
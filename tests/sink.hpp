@@ -0,0 +1,53 @@
+#pragma once
+
+#include "miniser/miniser.hpp"
+#include "miniser/stream.hpp"
+#include <algorithm>
+#include <array>
+#include <gtest/gtest.h>
+#include <span>
+#include <string>
+
+namespace test_stream {
+
+inline constexpr std::array<std::size_t, 4> chunk_sizes{1, 3, 16, 4096};
+
+/// A sink that appends all chunks to `out`
+inline auto append_to(std::string &out) {
+  return miniser::callback_sink([&out](std::string_view chunk) {
+    out.append(chunk);
+    return true;
+  });
+}
+
+/// Writes `value` with `serialize_to_sink` in chunks of at most `chunk` bytes.
+template <typename T> std::string to_sink(const T &value, std::size_t chunk) {
+  std::string out;
+  std::size_t max_chunk = 0;
+  auto sink = miniser::callback_sink([&](std::string_view data) {
+    max_chunk = std::max(max_chunk, data.size());
+    out.append(data);
+    return true;
+  });
+  EXPECT_TRUE(miniser::serialize_to_sink(value, sink, chunk));
+  EXPECT_LE(max_chunk, chunk);
+  return out;
+}
+
+/// Checks that `value` is written as `expected` in chunks of all `sizes`.
+template <typename T>
+void check_eq(const T &value, std::string_view expected,
+              std::span<const std::size_t> sizes = chunk_sizes) {
+  for (std::size_t chunk : sizes) {
+    EXPECT_EQ(to_sink(value, chunk), expected) << chunk;
+  }
+}
+
+/// Checks that `value` is written like `serialize` writes it.
+template <typename T> void check_same(const T &value) {
+  auto expected = miniser::serialize(value);
+  ASSERT_TRUE(expected.has_value());
+  check_eq(value, expected->view());
+}
+
+} // namespace test_stream
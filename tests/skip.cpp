@@ -0,0 +1,124 @@
+#include "equality.hpp"
+#include "miniser/plan.hpp"
+#include "miniser/stream.hpp"
+#include "miniser/validate.hpp"
+#include <gtest/gtest.h>
+
+namespace skip_test {
+
+struct Inner {
+  int a;
+};
+
+struct All {
+  int i;
+  double d;
+  bool b;
+  std::string s;
+  std::vector<int> v;
+  std::optional<int> o;
+  Inner inner;
+
+  bool operator==(const All &other) const {
+    return i == other.i && d == other.d && b == other.b && s == other.s &&
+           v == other.v && o == other.o && inner.a == other.inner.a;
+  }
+};
+
+struct Nulls {
+  int i;
+  std::optional<int> o;
+};
+
+struct Defaults {
+  int i;
+  std::string s;
+  std::optional<int> o;
+};
+
+// doesn't skip anything, but accepts missing fields
+struct Lenient {
+  int i;
+  std::vector<int> v;
+
+  bool operator==(const Lenient &other) const {
+    return i == other.i && v == other.v;
+  }
+};
+
+std::string to_stream(const auto &value) {
+  std::string out;
+  auto sink = miniser::callback_sink([&](std::string_view chunk) {
+    out.append(chunk);
+    return true;
+  });
+  EXPECT_TRUE(miniser::serialize_to_sink(value, sink));
+  return out;
+}
+
+} // namespace skip_test
+
+using namespace skip_test;
+
+namespace miniser {
+template <> inline constexpr skip skip_fields<All> = skip::all;
+template <> inline constexpr skip skip_fields<Nulls> = skip::null;
+template <>
+inline constexpr skip skip_fields<Defaults> = skip::default_value;
+template <> inline constexpr bool default_missing_fields<Lenient> = true;
+} // namespace miniser
+
+TEST(Skip, Serialize) {
+  test_ser::check_eq(All{}, R"({"inner":{"a":0}})");
+  test_ser::check_eq(
+      All{1, 0.5, true, "s", {1}, 2, {3}},
+      R"({"i":1,"d":0.5,"b":true,"s":"s","v":[1],"o":2,"inner":{"a":3}})");
+  test_ser::check_eq(All{.s = "", .o = 0}, R"({"o":0,"inner":{"a":0}})");
+
+  test_ser::check_eq(Nulls{}, R"({"i":0})");
+  test_ser::check_eq(Nulls{.o = 1}, R"({"i":0,"o":1})");
+
+  test_ser::check_eq(Defaults{}, R"({"s":"","o":null})");
+  test_ser::check_eq(Defaults{.i = -1}, R"({"i":-1,"s":"","o":null})");
+}
+
+TEST(Skip, DeserializeMissing) {
+  test_deser::check_eq<All>("{}", All{});
+  test_deser::check_eq<All>(R"({"s":"x","v":[1,2]})",
+                            All{.s = "x", .v = {1, 2}});
+  // present fields still have to be valid
+  test_deser::check_eq<All>(R"({"i":"x"})", std::nullopt);
+
+  test_deser::check_eq<Lenient>("{}", Lenient{});
+  test_deser::check_eq<Lenient>(R"({"v":[1]})", Lenient{.v = {1}});
+}
+
+TEST(Skip, RoundTrip) {
+  All all{.b = true, .v = {1}, .inner = {4}};
+  auto s = miniser::serialize(all);
+  ASSERT_TRUE(s.has_value());
+  EXPECT_EQ(miniser::deserialize<All>(s->view()), all);
+}
+
+TEST(Skip, Stream) {
+  for (const auto &all : {All{}, All{1, 0.5, true, "s", {1}, 2, {3}},
+                          All{.b = true, .o = 0}}) {
+    EXPECT_EQ(to_stream(all), miniser::serialize(all)->view());
+  }
+  EXPECT_EQ(to_stream(Nulls{}), R"({"i":0})");
+  EXPECT_EQ(to_stream(Defaults{}), R"({"s":"","o":null})");
+}
+
+TEST(Skip, Plan) {
+  All all{.d = 1.5, .s = "s", .inner = {2}};
+  EXPECT_EQ(miniser::serialize_planned(all)->view(),
+            miniser::serialize(all)->view());
+  EXPECT_EQ(miniser::deserialize_planned<All>(R"({"d":1.5})"), All{.d = 1.5});
+  EXPECT_EQ(miniser::deserialize_planned<Lenient>("{}"), Lenient{});
+}
+
+TEST(Skip, Validate) {
+  EXPECT_TRUE(miniser::matches_schema<All>("{}"));
+  EXPECT_TRUE(miniser::matches_schema<Lenient>("{}"));
+  EXPECT_FALSE(miniser::matches_schema<Lenient>(R"({"i":"x"})"));
+}
@@ -0,0 +1,139 @@
+#include "equality.hpp"
+#include "miniser/stream.hpp"
+#include "sink.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace stream_test {
+
+struct Item {
+  int id;
+  std::string name;
+  std::optional<double> price;
+  std::vector<std::uint8_t> tags;
+  float weight;
+};
+
+struct Export {
+  std::string title;
+  std::vector<Item> items;
+  std::variant<int, std::string> cursor;
+  bool done;
+};
+
+struct Unsorted {
+  int zeta;
+  std::string alpha;
+  std::optional<double> mid;
+};
+
+struct Circle {
+  double radius;
+  int x;
+};
+
+struct Rect {
+  int w;
+  int h;
+};
+
+using Internal = std::variant<Circle, Rect>;
+using Adjacent = std::variant<Rect, Circle>;
+
+} // namespace stream_test
+
+using namespace stream_test;
+using test_stream::check_same;
+
+namespace miniser {
+template <>
+inline constexpr tagging tag_variant<Internal> = tagging::internal;
+template <>
+inline constexpr tagging tag_variant<Adjacent> = tagging::adjacent;
+} // namespace miniser
+
+TEST(Stream, Primitives) {
+  check_same(42);
+  check_same(-42);
+  check_same(std::uint64_t{18446744073709551615U});
+  check_same(true);
+  check_same(1.5);
+  check_same(1.0);
+  check_same(0.1F);
+  check_same(std::string("a\"b\\c\n\t"));
+  check_same(std::optional<int>());
+  check_same(miniser::raw_number("123456789012345678901234567890"));
+  check_same(miniser::raw_json(R"({"a":[1,2]})"));
+}
+
+TEST(Stream, Reals) {
+  // laid out like yyjson: fixed notation unless the exponent is large
+  test_stream::check_eq(1e-7, "1e-7");
+  test_stream::check_eq(0.0001, "0.0001");
+  test_stream::check_eq(1e16, "10000000000000000.0");
+  test_stream::check_eq(1e21, "1e21");
+  test_stream::check_eq(1.5e300, "1.5e300");
+  for (double value : {1e-7, 0.0001, 1e16, 1e21, 1.5e300, -2.5e-10, 1e20,
+                       123456789012345680000.0, 5e-324, -0.0}) {
+    check_same(value);
+  }
+  check_same(1e-7F);
+  check_same(1e16F);
+  check_same(std::numeric_limits<float>::max());
+
+  // canonical output uses the same layout
+  EXPECT_EQ(miniser::serialize_canonical(1e16), "10000000000000000.0");
+  EXPECT_EQ(miniser::serialize_canonical(1.5e300), "1.5e300");
+}
+
+TEST(Stream, Aggregates) {
+  Export exp{
+      .title = "export",
+      .items =
+          {
+              Item{1, "first", 1.25, {1, 2}, 0.5F},
+              Item{2, "second", std::nullopt, {}, 2},
+          },
+      .cursor = std::string("next"),
+      .done = false,
+  };
+  check_same(exp);
+  check_same(std::vector<Export>{exp, exp});
+}
+
+TEST(Stream, Errors) {
+  auto failing = miniser::callback_sink([](std::string_view) { return false; });
+  EXPECT_FALSE(miniser::serialize_to_sink(std::string("x"), failing));
+
+  auto ignore = miniser::callback_sink([](std::string_view) { return true; });
+  EXPECT_FALSE(miniser::serialize_to_sink(
+      std::numeric_limits<double>::infinity(), ignore));
+  EXPECT_FALSE(miniser::serialize_to_sink(miniser::raw_json(), ignore));
+}
+
+TEST(Stream, Ostream) {
+  std::ostringstream os;
+  miniser::ostream_sink sink(os);
+  EXPECT_TRUE(miniser::serialize_to_sink(std::vector<int>{1, 2, 3}, sink, 2));
+  EXPECT_EQ(os.str(), "[1,2,3]");
+}
+
+TEST(Stream, Canonical) {
+  EXPECT_EQ(miniser::serialize_canonical(Unsorted{1, "a", -0.0}),
+            R"({"alpha":"a","mid":0.0,"zeta":1})");
+  EXPECT_EQ(miniser::serialize_canonical(
+                std::vector<Unsorted>{{1, "a", std::nullopt}, {2, "b", 1.5}}),
+            R"([{"alpha":"a","mid":null,"zeta":1},)"
+            R"({"alpha":"b","mid":1.5,"zeta":2}])");
+
+  // the tag is sorted with the fields
+  EXPECT_EQ(miniser::serialize_canonical(Internal(Circle{1, 2})),
+            R"({"radius":1.0,"type":"Circle","x":2})");
+  EXPECT_EQ(miniser::serialize_canonical(Internal(Rect{1, 2})),
+            R"({"h":2,"type":"Rect","w":1})");
+  EXPECT_EQ(miniser::serialize_canonical(Adjacent(Rect{1, 2})),
+            R"({"content":{"h":2,"w":1},"type":"Rect"})");
+
+  EXPECT_EQ(miniser::serialize_canonical(
+                std::numeric_limits<double>::infinity()), std::nullopt);
+}
@@ -0,0 +1,104 @@
+#include "equality.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace thread_cache_test {
+
+struct Record {
+  std::string name;
+  std::vector<std::uint32_t> values;
+
+  bool operator==(const Record &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+
+Record make_record(std::size_t n) {
+  Record r{"record", {}};
+  for (std::size_t i = 0; i < n; i++) {
+    r.values.push_back(static_cast<std::uint32_t>(i));
+  }
+  return r;
+}
+
+} // namespace thread_cache_test
+
+using namespace thread_cache_test;
+
+TEST(ThreadCache, DisabledByDefault) {
+  EXPECT_EQ(miniser::thread_cache::allocator(), nullptr);
+  auto s = miniser::serialize(make_record(10));
+  ASSERT_TRUE(s.has_value());
+  EXPECT_EQ(miniser::thread_cache::cached_bytes(), 0U);
+}
+
+TEST(ThreadCache, Reuse) {
+  miniser::thread_cache::set_limit(1024 * 1024);
+  ASSERT_NE(miniser::thread_cache::allocator(), nullptr);
+
+  auto record = make_record(1000);
+  for (int i = 0; i < 10; i++) {
+    auto s = miniser::serialize(record);
+    ASSERT_TRUE(s.has_value());
+    EXPECT_EQ(miniser::deserialize<Record>(s->view()), record);
+  }
+  // freed documents are kept
+  EXPECT_GT(miniser::thread_cache::cached_bytes(), 0U);
+  EXPECT_LE(miniser::thread_cache::cached_bytes(), 1024U * 1024U);
+
+  miniser::thread_cache::trim();
+  EXPECT_EQ(miniser::thread_cache::cached_bytes(), 0U);
+
+  miniser::thread_cache::set_limit(0);
+  EXPECT_EQ(miniser::thread_cache::allocator(), nullptr);
+}
+
+TEST(ThreadCache, Limit) {
+  miniser::thread_cache::set_limit(64);
+  auto record = make_record(1000);
+  auto s = miniser::serialize(record);
+  ASSERT_TRUE(s.has_value());
+  EXPECT_EQ(miniser::deserialize<Record>(s->view()), record);
+  EXPECT_LE(miniser::thread_cache::cached_bytes(), 64U);
+  miniser::thread_cache::set_limit(0);
+}
+
+TEST(ThreadCache, OtherThread) {
+  miniser::thread_cache::set_limit(1024 * 1024);
+  auto borrowed =
+      miniser::deserialize_borrowed<Record>(R"({"name":"x","values":[1]})");
+  ASSERT_TRUE(borrowed.has_value());
+  miniser::thread_cache::set_limit(0);
+
+  // the document is freed on a thread without a cache
+  std::thread([b = std::move(*borrowed)]() mutable {
+    auto local = std::move(b);
+    EXPECT_EQ(local->name, "x");
+  }).join();
+}
+
+TEST(ThreadCache, FreedAfterThreadExit) {
+  std::optional<miniser::borrowed<Record>> borrowed;
+  std::thread([&] {
+    miniser::thread_cache::set_limit(1024 * 1024);
+    borrowed = miniser::deserialize_borrowed<Record>(
+        R"({"name":"x","values":[1,2]})");
+  }).join();
+  ASSERT_TRUE(borrowed.has_value());
+  EXPECT_EQ((*borrowed)->values.size(), 2U);
+
+  // the cache of the exited thread is released with the document
+  borrowed.reset();
+  EXPECT_EQ(miniser::thread_cache::cached_bytes(), 0U);
+}
+
+TEST(ThreadCache, NotCreatedUnlessEnabled) {
+  std::size_t cached = 1;
+  std::thread([&] {
+    // serializing and disabling don't create a cache
+    auto s = miniser::serialize(make_record(10));
+    miniser::thread_cache::set_limit(0);
+    cached = miniser::thread_cache::cached_bytes();
+  }).join();
+  EXPECT_EQ(cached, 0U);
+}
@@ -0,0 +1,104 @@
+#include "equality.hpp"
+#include "miniser/validate.hpp"
+#include <gtest/gtest.h>
+
+namespace validate_test {
+
+struct Plain {
+  int i;
+  std::string name;
+  bool f;
+
+  bool operator==(const Plain &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+
+struct Nested {
+  std::uint32_t id;
+  std::optional<Plain> p;
+  std::vector<double> values;
+
+  bool operator==(const Nested &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+
+} // namespace validate_test
+
+using namespace validate_test;
+using miniser::matches_schema;
+
+TEST(Validate, Primitives) {
+  EXPECT_TRUE(matches_schema<int>("-1"));
+  EXPECT_FALSE(matches_schema<int>("1.5"));
+  EXPECT_FALSE(matches_schema<int>("\"1\""));
+  EXPECT_TRUE(matches_schema<std::uint8_t>("1"));
+  EXPECT_FALSE(matches_schema<std::uint8_t>("-1"));
+  EXPECT_TRUE(matches_schema<double>("1e5"));
+  EXPECT_TRUE(matches_schema<bool>(" true "));
+  EXPECT_FALSE(matches_schema<bool>("null"));
+  EXPECT_TRUE(matches_schema<std::string>(R"("a\"b")"));
+  EXPECT_FALSE(matches_schema<std::string>(R"("a\xb")"));
+  EXPECT_TRUE(matches_schema<std::optional<int>>("null"));
+  EXPECT_FALSE(matches_schema<int>("1 2"));
+}
+
+TEST(Validate, Aggregates) {
+  EXPECT_TRUE(matches_schema<Plain>(R"({"i":1,"f":true,"name":"abc"})"));
+  EXPECT_TRUE(
+      matches_schema<Plain>(R"({"i":1,"x":[{}],"f":true,"name":"abc"})"));
+  EXPECT_FALSE(matches_schema<Plain>(R"({"i":1,"f":true})"));
+  EXPECT_FALSE(matches_schema<Plain>(R"({"i":false,"f":true,"name":"abc"})"));
+  EXPECT_FALSE(matches_schema<Plain>(R"({"i":1,"f":true,"name":"abc",})"));
+  // like deserialize, only the first of duplicate keys is used (later ones
+  // must still be well-formed)
+  EXPECT_TRUE(
+      matches_schema<Plain>(R"({"i":1,"i":"x","f":true,"name":"abc"})"));
+  EXPECT_FALSE(
+      matches_schema<Plain>(R"({"i":"x","i":1,"f":true,"name":"abc"})"));
+  EXPECT_FALSE(matches_schema<Plain>(R"({"i":1,"i":[,"f":true,"name":"abc"})"));
+
+  EXPECT_TRUE(matches_schema<Nested>(R"({"id":1,"values":[1,2.5]})"));
+  EXPECT_TRUE(matches_schema<Nested>(
+      R"({"id":1,"values":[],"p":{"i":1,"f":true,"name":"abc"}})"));
+  EXPECT_FALSE(matches_schema<Nested>(R"({"id":1,"values":[1,"2"]})"));
+  EXPECT_FALSE(matches_schema<Nested>(R"({"id":-1,"values":[]})"));
+  EXPECT_TRUE(matches_schema<Nested>(R"({"id":1,"values":[]})"));
+  // like deserialize, an optional is left empty if its value doesn't match
+  EXPECT_TRUE(matches_schema<Nested>(
+      R"({"id":1,"values":[],"p":{"i":false,"f":true,"name":"abc"}})"));
+  EXPECT_TRUE(matches_schema<std::optional<int>>("\"1\""));
+  EXPECT_FALSE(matches_schema<Nested>(R"({"id":1,"values":[],"p":{]})"));
+}
+
+TEST(Validate, Limits) {
+  EXPECT_FALSE(matches_schema<std::vector<std::vector<int>>>("[[1]]",
+                                                             {.max_depth = 1}));
+  EXPECT_TRUE(matches_schema<std::vector<std::vector<int>>>("[[1]]",
+                                                            {.max_depth = 2}));
+  EXPECT_FALSE(matches_schema<Plain>(R"({"i":1,"f":true,"name":"abc"})",
+                                     {.max_elements = 2}));
+  EXPECT_FALSE(matches_schema<Plain>(R"({"i":1,"f":true,"name":"abc"})",
+                                     {.max_string_length = 2}));
+  // unknown values count as well
+  EXPECT_FALSE(matches_schema<Plain>(
+      R"({"i":1,"f":true,"name":"a","x":[[[[]]]]})", {.max_depth = 3}));
+}
+
+TEST(Validate, Deserialize) {
+  EXPECT_EQ(miniser::deserialize_validated<Plain>(
+                R"({"i":1,"f":true,"name":"abc","i":"x"})"),
+            (Plain{1, "abc", true}));
+  EXPECT_EQ(miniser::deserialize_validated<Plain>(
+                R"({"i":1,"f":true,"name":"abc"})"),
+            (Plain{1, "abc", true}));
+  EXPECT_EQ(miniser::deserialize_validated<Plain>(R"({"i":1,"f":true})"),
+            std::nullopt);
+  EXPECT_EQ(miniser::deserialize_validated<Plain>(
+                R"({"i":1,"f":true,"name":"abc"})", {.max_elements = 1}),
+            std::nullopt);
+  EXPECT_EQ(miniser::deserialize_validated<Nested>(
+                R"({"id":1,"values":[],"p":{"i":false,"f":true,"name":"d"}})"),
+            (Nested{1, std::nullopt, {}}));
+}
@@ -0,0 +1,138 @@
+#include "equality.hpp"
+#include <gtest/gtest.h>
+
+namespace variant_test {
+
+struct Circle {
+  double radius;
+
+  bool operator==(const Circle &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+
+struct Rect {
+  int w;
+  int h;
+
+  bool operator==(const Rect &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+
+using External = std::variant<Circle, Rect>;
+
+struct Drawing {
+  std::variant<Circle, Rect> shape;
+
+  bool operator==(const Drawing &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+
+using Tagged = std::variant<Rect, Circle>;
+using Adjacent = std::variant<int, std::string>;
+
+namespace v1 {
+struct Msg {
+  int a;
+
+  bool operator==(const Msg &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+} // namespace v1
+
+namespace v2 {
+struct Msg {
+  int b;
+
+  bool operator==(const Msg &other) const {
+    return boost::pfr::eq_fields(*this, other);
+  }
+};
+} // namespace v2
+
+// both alternatives are named `Msg`, so one needs another tag
+using Versioned = std::variant<v1::Msg, v2::Msg>;
+
+} // namespace variant_test
+
+using namespace variant_test;
+
+namespace miniser {
+template <> inline constexpr tagging tag_variant<Tagged> = tagging::internal;
+template <> inline constexpr std::string_view variant_tag_field<Tagged> = "t";
+template <> inline constexpr tagging tag_variant<Adjacent> = tagging::adjacent;
+template <> inline constexpr std::string_view variant_tag<int> = "int";
+template <> inline constexpr std::string_view variant_tag<std::string> = "str";
+template <>
+inline constexpr std::string_view variant_tag<variant_test::v2::Msg> = "Msg2";
+} // namespace miniser
+
+TEST(Variant, Tags) {
+  static_assert(miniser::variant_tag<Circle> == "Circle");
+  static_assert(miniser::variant_tag<Rect> == "Rect");
+  static_assert(miniser::detail::variant_tags<External>::find("Rect") == 1);
+  static_assert(miniser::detail::variant_tags<External>::find("Square") == 2);
+}
+
+TEST(Variant, External) {
+  test_ser::check_eq<External>(Circle{1.5}, R"({"Circle":{"radius":1.5}})");
+  test_ser::check_eq<External>(Rect{1, 2}, R"({"Rect":{"w":1,"h":2}})");
+
+  test_deser::check_eq<External>(R"({"Circle":{"radius":1.5}})",
+                                 Circle{1.5});
+  test_deser::check_eq<External>(R"({"Rect":{"w":1,"h":2}})", Rect{1, 2});
+  test_deser::check_eq<External>(R"({"Rect":{"radius":1.5}})", std::nullopt);
+  test_deser::check_eq<External>(R"({"Square":{"w":1}})", std::nullopt);
+  test_deser::check_eq<External>(R"({"Rect":{"w":1,"h":2},"Circle":{}})",
+                                 std::nullopt);
+  test_deser::check_eq<External>("{}", std::nullopt);
+  test_deser::check_eq<External>(R"("Rect")", std::nullopt);
+}
+
+TEST(Variant, Internal) {
+  test_ser::check_eq<Tagged>(Rect{1, 2}, R"({"t":"Rect","w":1,"h":2})");
+  test_ser::check_eq<Tagged>(Circle{2}, R"({"t":"Circle","radius":2.0})");
+
+  test_deser::check_eq<Tagged>(R"({"w":1,"t":"Rect","h":2})", Rect{1, 2});
+  test_deser::check_eq<Tagged>(R"({"t":"Circle","radius":2})", Circle{2});
+  // the tag and unknown members are skipped when looking up the fields
+  test_deser::check_eq<Tagged>(R"({"t":"Rect","x":0,"w":1,"h":2})",
+                               Rect{1, 2});
+  test_deser::check_eq<std::vector<Tagged>>(
+      R"([{"t":"Rect","w":1,"h":2},{"t":"Circle","radius":2}])",
+      std::vector<Tagged>{Rect{1, 2}, Circle{2}});
+  test_deser::check_eq<Tagged>(R"({"t":"Circle","w":1,"h":2})",
+                               std::nullopt);
+  test_deser::check_eq<Tagged>(R"({"w":1,"h":2})", std::nullopt);
+  test_deser::check_eq<Tagged>(R"({"t":1,"w":1,"h":2})", std::nullopt);
+}
+
+TEST(Variant, Adjacent) {
+  test_ser::check_eq<Adjacent>(42, R"({"type":"int","content":42})");
+  test_ser::check_eq<Adjacent>(std::string("x"),
+                               R"({"type":"str","content":"x"})");
+
+  test_deser::check_eq<Adjacent>(R"({"content":42,"type":"int"})", 42);
+  test_deser::check_eq<Adjacent>(R"({"type":"str","content":"x"})",
+                                 std::string("x"));
+  test_deser::check_eq<Adjacent>(R"({"type":"str","content":42})",
+                                 std::nullopt);
+  test_deser::check_eq<Adjacent>(R"({"type":"int"})", std::nullopt);
+}
+
+TEST(Variant, ExternalField) {
+  test_ser::check_eq<Drawing>(Drawing{Rect{1, 2}},
+                               R"({"shape":{"Rect":{"w":1,"h":2}}})");
+  test_deser::check_eq<Drawing>(R"({"shape":{"Circle":{"radius":1}}})",
+                                 Drawing{Circle{1}});
+}
+
+TEST(Variant, SameName) {
+  static_assert(miniser::detail::variant_tags<Versioned>::unique);
+  test_ser::check_eq<Versioned>(v1::Msg{1}, R"({"Msg":{"a":1}})");
+  test_ser::check_eq<Versioned>(v2::Msg{2}, R"({"Msg2":{"b":2}})");
+  test_deser::check_eq<Versioned>(R"({"Msg2":{"b":2}})", v2::Msg{2});
+}